@@ -7,6 +7,10 @@
 #include "gloo/shaders/PhongShader.hpp"
 #include "gloo/shaders/SimpleShader.hpp"
 #include "gloo/InputManager.hpp"
+#include "gloo/Profiler.hpp"
+
+#include "spline/CubicSpline.hpp"
+#include "spline/SplineTessellator.hpp"
 
 namespace GLOO {
 CurveNode::CurveNode(std::vector<glm::vec3> control_points, SplineBasis spline_basis) {
@@ -26,8 +30,8 @@ CurveNode::CurveNode(std::vector<glm::vec3> control_points, SplineBasis spline_b
   // Initialize the VertexObjects and shaders used to render the control points,
   // the curve, and the tangent line.
   sphere_mesh_ = PrimitiveFactory::CreateSphere(0.015f, 25, 25);
-  curve_polyline_ = std::make_shared<VertexObject>();
-  tangent_line_ = std::make_shared<VertexObject>();
+  curve_polyline_ = std::make_shared<VertexObject>(BufferUsage::Dynamic);
+  tangent_line_ = std::make_shared<VertexObject>(BufferUsage::Dynamic);
   shader_ = std::make_shared<PhongShader>();
   polyline_shader_ = std::make_shared<SimpleShader>();
 
@@ -93,18 +97,12 @@ void CurveNode::ToggleSplineBasis() {
 
 void CurveNode::ConvertGeometry() {
   // TODO: implement converting the control points between bases.
-  glm::mat4x4 B_1 = glm::mat4(1, 0, 0, 0, -3, 3, 0, 0, 3, -6, 3, 0, -1, 3, -3, 1);
-  glm::mat4x4 B_2 = glm::mat4(1/6.0, 2/3.0, 1/6.0, 0.0, -1/2.0, 0.0, 1/2.0, 0, 1/2.0, -1, 1/2.0, 0, -1/6.0, 1/2.0, -1/2.0, 1/6.0);
-  glm::mat4x3 G = control_pts_matrix_;
-
   if (b_signal) {
-    glm::mat4x4 B_2_inv = glm::inverse(B_2);
-    glm::mat4x3 new_G = G * B_1 * B_2_inv;
-    control_pts_matrix_ = new_G;
+    control_pts_matrix_ = CubicSpline::ConvertBasis(
+        control_pts_matrix_, SplineBasis::Bezier, SplineBasis::BSpline);
   } else {
-    glm::mat4x4 B_1_inv = glm::inverse(B_1);
-    glm::mat4x3 new_G = G * B_2 * B_1_inv;
-    control_pts_matrix_ = new_G;
+    control_pts_matrix_ = CubicSpline::ConvertBasis(
+        control_pts_matrix_, SplineBasis::BSpline, SplineBasis::Bezier);
   }
 
   PlotCurve();
@@ -112,21 +110,7 @@ void CurveNode::ConvertGeometry() {
 
 CurvePoint CurveNode::EvalCurve(float t) {
   // TODO: implement evaluating the spline curve at parameter value t.
-  glm::mat4x3 G = control_pts_matrix_;
-
-  glm::mat4x4 B;
-  if (spline_basis_ == SplineBasis::Bezier) {
-    B = glm::mat4(1, 0, 0, 0, -3, 3, 0, 0, 3, -6, 3, 0, -1, 3, -3, 1);
-  } else {
-    B = glm::mat4(1/6.0, 2/3.0, 1/6.0, 0.0, -1/2.0, 0.0, 1/2.0, 0, 1/2.0, -1, 1/2.0, 0, -1/6.0, 1/2.0, -1/2.0, 1/6.0);
-  }
-
-  glm::vec4 monomial = glm::vec4(1, t, t*t, t*t*t);
-
-  glm::vec3 P = G * B * monomial;
-  glm::vec4 d_monomial = glm::vec4(0, 1, 2*t, 3*t*t);
-  glm::vec3 T = G * B * d_monomial;
-  return CurvePoint{P, T};
+  return CubicSpline::EvalCurve(control_pts_matrix_, spline_basis_, t);
 }
 
 void CurveNode::InitCurve() {
@@ -135,17 +119,10 @@ void CurveNode::InitCurve() {
   // VertexObjects and shaders that are initialized in the class constructor.
 
   auto positions = make_unique<PositionArray>();
-  for (int i = 0; i < N_SUBDIV_; i++) {
-    float t = (float)i / (N_SUBDIV_-1);
-    CurvePoint curve_point = EvalCurve(t);
-    positions->push_back(curve_point.P);
-  }
-
-  auto indices = make_unique<IndexArray>();
-  for (int i = 0; i < N_SUBDIV_-1; i++) {
-    indices->push_back(i);
-    indices->push_back(i + 1);
-  }
+  SplineTessellator::SampleCubicCurve(control_pts_matrix_, spline_basis_,
+                                      N_SUBDIV_, *positions);
+  auto indices = make_unique<IndexArray>(
+      SplineTessellator::GetPolylineIndices(N_SUBDIV_));
 
   curve_polyline_->UpdatePositions(std::move(positions));
   curve_polyline_->UpdateIndices(std::move(indices));
@@ -164,13 +141,11 @@ void CurveNode::InitCurve() {
 }
 
 void CurveNode::PlotCurve() {
+  ScopedTimer timer("CurveNode::PlotCurve");
   // TODO: plot the curve by updating the positions of its VertexObject.
   auto positions = make_unique<PositionArray>();
-  for (int i = 0; i < N_SUBDIV_; i++) {
-    float t = (float)i / (N_SUBDIV_-1);
-    CurvePoint curve_point = EvalCurve(t);
-    positions->push_back(curve_point.P);
-  }
+  SplineTessellator::SampleCubicCurve(control_pts_matrix_, spline_basis_,
+                                      N_SUBDIV_, *positions);
   curve_polyline_->UpdatePositions(std::move(positions));
 
   for (int i = 0; i < 4; i++) {
@@ -8,15 +8,9 @@
 #include "gloo/VertexObject.hpp"
 #include "gloo/shaders/ShaderProgram.hpp"
 
-namespace GLOO {
-
-enum class SplineBasis { Bezier, BSpline };
-
-struct CurvePoint {
-  glm::vec3 P;
-  glm::vec3 T;
-};
+#include "spline/SplineTypes.hpp"
 
+namespace GLOO {
 class CurveNode : public SceneNode {
  public:
   CurveNode(std::vector<glm::vec3> control_points, SplineBasis spline_basis);
@@ -0,0 +1,53 @@
+#include "CurveTemplateNode.hpp"
+
+#include "gloo/components/MaterialComponent.hpp"
+#include "gloo/components/RenderingComponent.hpp"
+#include "gloo/components/ShadingComponent.hpp"
+#include "gloo/shaders/SimpleShader.hpp"
+
+#include "spline/BezierExtraction.hpp"
+#include "spline/SplineTessellator.hpp"
+
+namespace GLOO {
+CurveTemplateNode::CurveTemplateNode(const NURBSCurveData& curve,
+                                     const glm::vec3& color)
+    : offsets_changed_(false) {
+  RationalBezierCurve bezier;
+  BezierExtraction::ExtractCurve(curve, bezier);
+  auto positions = make_unique<PositionArray>();
+  SplineTessellator::SampleCurve(bezier, N_SUBDIV_, *positions);
+  auto indices = make_unique<IndexArray>(
+      SplineTessellator::GetPolylineIndices(N_SUBDIV_));
+
+  curve_polyline_ = std::make_shared<VertexObject>();
+  curve_polyline_->SetRetainCPUData(false);
+  curve_polyline_->UpdatePositions(std::move(positions));
+  curve_polyline_->UpdateIndices(std::move(indices));
+  // No copies are drawn until the first is added.
+  curve_polyline_->UpdateInstanceOffsets(offsets_);
+
+  CreateComponent<ShadingComponent>(std::make_shared<SimpleShader>());
+  auto& rc = CreateComponent<RenderingComponent>(curve_polyline_);
+  rc.SetDrawMode(DrawMode::Lines);
+  auto material = std::make_shared<Material>(color, color, color, 0);
+  CreateComponent<MaterialComponent>(material);
+}
+
+void CurveTemplateNode::Update(double delta_time) {
+  if (offsets_changed_) {
+    curve_polyline_->UpdateInstanceOffsets(offsets_);
+    offsets_changed_ = false;
+  }
+}
+
+int CurveTemplateNode::AddInstance(const glm::vec3& offset) {
+  offsets_.push_back(offset);
+  offsets_changed_ = true;
+  return GetInstanceCount() - 1;
+}
+
+void CurveTemplateNode::SetInstanceOffset(int index, const glm::vec3& offset) {
+  offsets_.at(index) = offset;
+  offsets_changed_ = true;
+}
+}  // namespace GLOO
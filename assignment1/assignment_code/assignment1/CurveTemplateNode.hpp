@@ -0,0 +1,37 @@
+#ifndef CURVE_TEMPLATE_NODE_H_
+#define CURVE_TEMPLATE_NODE_H_
+
+#include <vector>
+
+#include "gloo/SceneNode.hpp"
+#include "gloo/VertexObject.hpp"
+
+#include "spline/SplineTypes.hpp"
+
+namespace GLOO {
+// Translated copies of one NURBS curve, such as the notes of a score. The
+// curve is tessellated once and all of its copies are drawn by a single
+// instanced draw call. Copies have no control points to edit.
+class CurveTemplateNode : public SceneNode {
+ public:
+  CurveTemplateNode(const NURBSCurveData& curve, const glm::vec3& color);
+  void Update(double delta_time) override;
+
+  // Returns the index of the new copy.
+  int AddInstance(const glm::vec3& offset);
+  void SetInstanceOffset(int index, const glm::vec3& offset);
+  int GetInstanceCount() const {
+    return static_cast<int>(offsets_.size());
+  }
+
+ private:
+  std::shared_ptr<VertexObject> curve_polyline_;
+  std::vector<glm::vec3> offsets_;
+  // Offsets are uploaded on the next Update.
+  bool offsets_changed_;
+
+  const int N_SUBDIV_ = 50;
+};
+}  // namespace GLOO
+
+#endif
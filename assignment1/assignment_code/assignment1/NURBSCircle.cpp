@@ -25,18 +25,9 @@ NURBSNode* NURBSCircle::GetNurbsNodePtr(){
 }
 
 void NURBSCircle::UpdateCenter(glm::vec3 new_center){ // unused function
+    // A move keeps the shape, so the circle is not re-evaluated.
+    nurbs_circle_node_ptr_->Translate(new_center - center_);
     center_ = new_center;
-    std::vector<glm::vec3> new_control_points;
-    new_control_points.push_back(glm::vec3(center_.x + radius_, center_.y, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x + radius_, center_.y + radius_, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x, center_.y + radius_, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x - radius_, center_.y + radius_, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x - radius_, center_.y, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x - radius_, center_.y - radius_, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x, center_.y - radius_, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x + radius_, center_.y - radius_, center_.z));
-    new_control_points.push_back(glm::vec3(center_.x + radius_, center_.y, center_.z));
-    nurbs_circle_node_ptr_->UpdateControlPointsPositions(new_control_points);
 }
 
 std::vector<float> NURBSCircle::GetKnots() {
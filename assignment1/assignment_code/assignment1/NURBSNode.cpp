@@ -1,4 +1,5 @@
 #include "NURBSNode.hpp"
+#include <algorithm>
 #include <string>
 
 #include "gloo/debug/PrimitiveFactory.hpp"
@@ -8,187 +9,126 @@
 #include "gloo/shaders/PhongShader.hpp"
 #include "gloo/shaders/SimpleShader.hpp"
 #include "gloo/InputManager.hpp"
+#include "gloo/Profiler.hpp"
+
+#include "spline/BezierExtraction.hpp"
+#include "spline/BSplineBasis.hpp"
+#include "spline/CurveBatch.hpp"
+#include "spline/SplineTessellator.hpp"
+
+namespace {
+// Offset of the keyboard edits (WASDZX); zero if no key is pressed.
+glm::vec3 GetKeyOffset() {
+    const float kStep = 0.05f;
+    auto& input_manager = GLOO::InputManager::GetInstance();
+    if (input_manager.IsKeyPressed('W')) {
+        return glm::vec3(0.f, kStep, 0.f);
+    } else if (input_manager.IsKeyPressed('A')) {
+        return glm::vec3(-kStep, 0.f, 0.f);
+    } else if (input_manager.IsKeyPressed('S')) {
+        return glm::vec3(0.f, -kStep, 0.f);
+    } else if (input_manager.IsKeyPressed('D')) {
+        return glm::vec3(kStep, 0.f, 0.f);
+    } else if (input_manager.IsKeyPressed('Z')) {
+        return glm::vec3(0.f, 0.f, -kStep);
+    } else if (input_manager.IsKeyPressed('X')) {
+        return glm::vec3(0.f, 0.f, kStep);
+    }
+    return glm::vec3(0.f);
+}
+}  // namespace
 
 namespace GLOO {
 NURBSNode::NURBSNode(int degree, std::vector<glm::vec3> control_points, std::vector<float> weights, std::vector<float> knots, NURBSBasis spline_basis, char curve_type, bool curve_being_edited) {
-    degree_ = degree;
-    control_pts_ = control_points;
-    knots_ = knots;
+    curve_.degree = degree;
+    curve_.control_points = control_points;
+    curve_.knots = KnotVector(degree, knots);
     spline_basis_ = spline_basis;
-    weights_ = weights;
+    curve_.weights = weights;
     curve_type_ = curve_type;
     curve_being_edited_ = curve_being_edited;
 
     // Initialize the VertexObjects and shaders used to render the control points,
     // the curve, and the tangent line.
     sphere_mesh_ = PrimitiveFactory::CreateSphere(0.15f, 25, 25);
-    curve_polyline_ = std::make_shared<VertexObject>();
+    curve_polyline_ = std::make_shared<VertexObject>(BufferUsage::Dynamic);
+    curve_polyline_->SetRetainCPUData(false);
     tangent_line_ = std::make_shared<VertexObject>();
     shader_ = std::make_shared<PhongShader>();
     polyline_shader_ = std::make_shared<SimpleShader>();
 
     control_point_nodes_ = std::vector<SceneNode*>();
     selected_control_point_ = 0;
+    curve_plotted_ = false;
+    batch_ = nullptr;
+    batch_id_ = -1;
 
+    BezierExtraction::ExtractCurve(curve_, bezier_);
     InitCurveAndControlPoints();
     PlotControlPoints();
 }
 
 std::vector<glm::vec3> NURBSNode::GetControlPointsLocations(){
-    return control_pts_;
+    glm::mat4 M = GetTransform().GetLocalToParentMatrix();
+    std::vector<glm::vec3> locations;
+    for (const glm::vec3& point : curve_.control_points) {
+        locations.push_back(glm::vec3(M * glm::vec4(point, 1.0f)));
+    }
+    return locations;
 }
 
 std::vector<float> NURBSNode::GetWeights(){
-    return weights_;
+    return curve_.weights;
 }
 
 std::vector<float> NURBSNode::GetKnotVector(){
-    return knots_;
+    return curve_.knots.GetKnots();
 }
 
 int NURBSNode::GetDegree(){
-    return degree_;
+    return curve_.degree;
 }
 
-// Adapted from https://www.codeproject.com/Articles/1095142/Generate-and-understand-NURBS-curves
-// Dynamic Programming approach to calculate value of basis functions at time u
-float NURBSNode::CalcNip(int control_point_i, int degree, float time_u, std::vector<float> knots){ 
-    int i = control_point_i; // converting variable names to what is used in the textbook
-    int p = degree;
-    std::vector<float> U = knots;
-    float u = time_u;
-
-    std::vector<float> N(p + 1);
-    float saved;
-    float temp;
-
-    int m = U.size() - 1;
-    if ((i == 0 && u == U[0]) || (i == (m - p - 1) && u == U[m])){ 
-        return 1.0;
-    }
-    if (u < U[i] || u >= U[i + p + 1]){ // avoid division by 0
-        return 0.0;
-    }
-
-    for (int j = 0; j <= p; j++){
-        if (u >= U[i + j] && u < U[i + j + 1]){
-            N[j] = 1.0;
-        }
-        else{
-            N[j] = 0.0;
-        }
-    }
-
-    for (int k = 1; k <= p; k++){
-        if (N[0] == 0){
-            saved = 0.0;
-        }
-        else{
-            saved = ((u - U[i]) * N[0]) / (U[i + k] - U[i]);
-        }
-        for (int j = 0; j < p - k + 1; j++){
-            float Uleft = U[i + j + 1];
-            float Uright = U[i + j + k + 1];
-
-            if (N[j + 1] == 0){
-                N[j] = saved;
-                saved = 0.0;
-            }
-            else{
-                temp = N[j + 1] / (Uright - Uleft);
-                N[j] = saved + (Uright - u) * temp;
-                saved = (u - Uleft) * temp;
-            }
-        }
-    }
-    return N[0];
+float NURBSNode::CalcNip(int control_point_i, int degree, float time_u, const std::vector<float>& knots){
+    return BSplineBasis::Evaluate(control_point_i, degree, time_u, knots);
 }
 
-// 
 std::vector<float> NURBSNode::CalcKnotVector(bool clamped_ends, bool adding_new_point){
-    float n;
+    int n;
     if (adding_new_point){ // eg when a new control point is added, expand the knot vector
-        n = knots_.size();
+        n = curve_.knots.GetKnots().size();
     } else {
-        n = knots_.size() - 1;
-    }
-    std::vector<float> new_knots;
-    new_knots.push_back(0);
-    for (int i = 1; i <= n; i++){
-        new_knots.push_back(i/n);
-    }
-
-    if (clamped_ends){ // if the ends are clamped, the curve goes through the first and last control points
-        for (int i = 0; i <= degree_; i++){
-            new_knots[i] = 0.0;
-            new_knots[n-i] = 1.0;
-        }
+        n = curve_.knots.GetKnots().size() - 1;
     }
-
-    knots_ = new_knots;
+    // if the ends are clamped, the curve goes through the first and last control points
+    curve_.knots = KnotVector(curve_.degree, BSplineBasis::UniformKnots(curve_.degree, n, clamped_ends));
+    BezierExtraction::ExtractCurve(curve_, bezier_);
     PlotControlPoints();
     PlotCurve();
 
-    return knots_;
+    return curve_.knots.GetKnots();
 }
 
 std::vector<float> NURBSNode::CalcKnotVector2(int degree, float knots_size, bool clamped_ends){
-    float n = knots_size;
-    std::vector<float> new_knots;
-    new_knots.push_back(0);
-    for (int i = 1; i <= n; i++){
-        new_knots.push_back(i/n);
-    }
-
-    if (clamped_ends){ // if the ends are clamped, the curve goes through the first and last control points
-        for (int i = 0; i <= degree; i++){
-            new_knots[i] = 0.0;
-            new_knots[n-i] = 1.0;
-        }
-    }
-
-    return new_knots;
+    return BSplineBasis::UniformKnots(degree, static_cast<int>(knots_size), clamped_ends);
 }
 
 // Evaluates the curve at time t. In many textbooks, the variable "u" is used instead.
-NURBSPoint NURBSNode::EvalCurve(float t) { 
-    NURBSPoint curve_point;
-    curve_point.P = glm::vec3(0.0f);
-    curve_point.T = glm::vec3(0.0f);
-    float rationalWeight = 0.0; // the denominator
-
-    for (int i = 0; i < control_pts_.size(); i++){
-        float temp = CalcNip(i, degree_, t, knots_) * weights_[i];
-        rationalWeight += temp;
-    }
-
-    for (int i = 0; i < control_pts_.size(); i++){
-        float temp = CalcNip(i, degree_, t, knots_);
-        curve_point.P += control_pts_[i] * weights_[i] * temp/rationalWeight;
-    }
-    return curve_point;
+NURBSPoint NURBSNode::EvalCurve(float t) {
+    NURBSPoint point = BezierExtraction::EvalCurve(bezier_, t);
+    glm::mat4 M = GetTransform().GetLocalToParentMatrix();
+    point.P = glm::vec3(M * glm::vec4(point.P, 1.0f));
+    point.T = glm::mat3(M) * point.T;
+    float length = glm::length(point.T);
+    if (length > 0.0f)
+        point.T /= length;
+    return point;
 }
 
 // Initial rendering of curve and control points. Fills in all relavant vectors.
 void NURBSNode::InitCurveAndControlPoints() {
-    // initialize curve
-    float start = knots_[degree_];
-    float end = knots_[knots_.size()-degree_-1];
-    float interval_length = end-start;
-    auto positions = make_unique<PositionArray>();
-    for (int i = 0; i < N_SUBDIV_; i++) {
-        float t = ((float)i / (N_SUBDIV_ - 1)) * interval_length + start;
-        NURBSPoint curve_point = EvalCurve(t);
-        positions->push_back(curve_point.P);
-    }
-
-    auto indices = make_unique<IndexArray>();
-    for (int i = 0; i < N_SUBDIV_ - 1; i++) {
-        indices->push_back(i);
-        indices->push_back(i + 1);
-    }
-
-    curve_polyline_->UpdatePositions(std::move(positions));
+    // initialize curve; its positions come from PlotCurves or the first Update
+    auto indices = make_unique<IndexArray>(SplineTessellator::GetPolylineIndices(N_SUBDIV_));
     curve_polyline_->UpdateIndices(std::move(indices));
 
     auto polyline_node = make_unique<SceneNode>();
@@ -201,12 +141,13 @@ void NURBSNode::InitCurveAndControlPoints() {
     auto material = std::make_shared<Material>(color, color, color, 0);
     polyline_node->CreateComponent<MaterialComponent>(material);
 
+    curve_node_ = polyline_node.get();
     AddChild(std::move(polyline_node));
 
     // initialize control points
-    for (int i = 0; i < control_pts_.size(); i++) {
+    for (int i = 0; i < curve_.control_points.size(); i++) {
         auto point_node = make_unique<SceneNode>();
-        point_node->GetTransform().SetPosition(control_pts_[i]);
+        point_node->GetTransform().SetPosition(curve_.control_points[i]);
 
         point_node->CreateComponent<ShadingComponent>(shader_);
         
@@ -225,52 +166,116 @@ void NURBSNode::InitCurveAndControlPoints() {
 
 // Re-render the curve (when control points or knot vector are edited)
 void NURBSNode::PlotCurve() {
-    float start = knots_[degree_];
-    float end = knots_[knots_.size()-degree_-1];
-    float interval_length = end-start;
-    auto positions = make_unique<PositionArray>();
-    for (int i = 0; i < N_SUBDIV_; i++) {
-        float t = ((float)i / (N_SUBDIV_ - 1)) * interval_length + start;
-        NURBSPoint curve_point = EvalCurve(t);
-        positions->push_back(curve_point.P);
+    ScopedTimer timer("NURBSNode::PlotCurve");
+    SplineTessellator::SampleCurve(bezier_, N_SUBDIV_, curve_samples_);
+    auto positions = make_unique<PositionArray>(curve_samples_);
+    auto indices = make_unique<IndexArray>(SplineTessellator::GetPolylineIndices(N_SUBDIV_));
+
+    curve_polyline_->UpdatePositions(std::move(positions));
+    curve_polyline_->UpdateIndices(std::move(indices));
+    curve_plotted_ = true;
+    SyncBatch();
+}
+
+void NURBSNode::PlotCurves(const std::vector<NURBSNode*>& nodes) {
+    ScopedTimer timer("NURBSNode::PlotCurves");
+    std::vector<const NURBSCurveData*> curves;
+    for (NURBSNode* node : nodes) {
+        curves.push_back(&node->curve_);
     }
+    std::vector<std::pair<int, int>> slots;
+    std::vector<CurveBatch> batches = CurveBatch::Group(curves, slots);
 
-    auto indices = make_unique<IndexArray>();
-    for (int i = 0; i < N_SUBDIV_ - 1; i++) {
-        indices->push_back(i);
-        indices->push_back(i + 1);
+    std::vector<std::vector<glm::vec3>> samples(batches.size());
+    for (size_t b = 0; b < batches.size(); b++) {
+        batches[b].Sample(N_SUBDIV_, samples[b]);
+    }
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (slots[i].first < 0) {
+            nodes[i]->PlotCurve();
+            continue;
+        }
+        auto first = samples[slots[i].first].begin() + slots[i].second * N_SUBDIV_;
+        nodes[i]->curve_samples_.assign(first, first + N_SUBDIV_);
+        auto positions = make_unique<PositionArray>(nodes[i]->curve_samples_);
+        nodes[i]->curve_polyline_->UpdatePositions(std::move(positions));
+        nodes[i]->curve_plotted_ = true;
+        nodes[i]->SyncBatch();
     }
+}
 
-    curve_polyline_->UpdatePositions(std::move(positions));
-    curve_polyline_->UpdateIndices(std::move(indices));
+void NURBSNode::UpdateSegments(int first, int last) {
+    BezierExtraction::UpdateCurve(curve_, first, last, bezier_);
+    PlotCurve();
 }
 
 // Re-render the control points (when control points or knot vector are edited)
 void NURBSNode::PlotControlPoints() {
-    for (int i = 0; i < control_pts_.size(); i++) {
-        control_point_nodes_[i]->GetTransform().SetPosition(control_pts_[i]);
+    for (int i = 0; i < curve_.control_points.size(); i++) {
+        control_point_nodes_[i]->GetTransform().SetPosition(curve_.control_points[i]);
     }
 }
 
+void NURBSNode::Translate(const glm::vec3& offset) {
+    Transform& transform = GetTransform();
+    transform.SetPosition(transform.GetPosition() + offset);
+    SyncBatch();
+}
+
+void NURBSNode::Rotate(const glm::quat& rotation) {
+    Transform& transform = GetTransform();
+    transform.SetRotation(rotation * transform.GetRotation());
+    transform.SetPosition(rotation * transform.GetPosition());
+    SyncBatch();
+}
+
+void NURBSNode::Scale(float factor) {
+    // Uniform scaling commutes with the rotation.
+    Transform& transform = GetTransform();
+    transform.SetScale(factor * transform.GetScale());
+    transform.SetPosition(factor * transform.GetPosition());
+    SyncBatch();
+}
+
+void NURBSNode::BakeTransform() {
+    glm::mat4 M = GetTransform().GetLocalToParentMatrix();
+    if (M == glm::mat4(1.0f)) {
+        return;
+    }
+    for (glm::vec3& point : curve_.control_points) {
+        point = glm::vec3(M * glm::vec4(point, 1.0f));
+    }
+    ResetTransform();
+    PlotControlPoints();
+    UpdateSegments(0, curve_.control_points.size() - 1);
+}
+
+void NURBSNode::ResetTransform() {
+    Transform& transform = GetTransform();
+    transform.SetPosition(glm::vec3(0.0f));
+    transform.SetRotation(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    transform.SetScale(glm::vec3(1.0f));
+}
+
 void NURBSNode::RemoveControlPoint(int index, bool clamped_ends){
-    if (control_pts_.size() == degree_ + 1){
+    if (curve_.control_points.size() == curve_.degree + 1){
         // do nothing
     } else {
         // std::cout << "HELLOOO " << std::endl; 
-        control_point_nodes_[index]->SetActive(false);
+        RemoveChild(*control_point_nodes_[index]);
         auto it1 = control_point_nodes_.begin() + index;
         control_point_nodes_.erase(it1);
-        auto it2 = control_pts_.begin() + index;
-        control_pts_.erase(it2);
-        auto it3 = weights_.begin() + index;
-        weights_.erase(it3);
-
-        // control_point_nodes_[index]->SetActive(false);
+        auto it2 = curve_.control_points.begin() + index;
+        curve_.control_points.erase(it2);
+        auto it3 = curve_.weights.begin() + index;
+        curve_.weights.erase(it3);
 
-        knots_ = CalcKnotVector2(degree_, knots_.size(), clamped_ends);
+        // One control point fewer takes one knot fewer.
+        curve_.knots = KnotVector(curve_.degree, CalcKnotVector2(curve_.degree, curve_.knots.GetKnots().size() - 2, clamped_ends));
+        BezierExtraction::ExtractCurve(curve_, bezier_);
 
-        if (selected_control_point_ == weights_.size()){
-            selected_control_point_ = weights_.size()-1;
+        if (selected_control_point_ == curve_.weights.size()){
+            selected_control_point_ = curve_.weights.size()-1;
         }
 
         PlotControlPoints();
@@ -288,77 +293,83 @@ void NURBSNode::RemoveControlPoint(int index, bool clamped_ends){
 
 void NURBSNode::ChangeEditStatus(bool curve_being_edited){
     curve_being_edited_ = curve_being_edited;
+    // Curves being edited are re-plotted often, so they leave the batch.
+    if (curve_being_edited_) {
+        LeaveBatch();
+    } else {
+        JoinBatch();
+    }
+}
+
+void NURBSNode::SetBatch(PolylineBatchNode* batch){
+    LeaveBatch();
+    batch_ = batch;
+    if (!curve_being_edited_) {
+        JoinBatch();
+    }
+}
+
+void NURBSNode::JoinBatch(){
+    if (batch_ == nullptr || batch_id_ >= 0) {
+        return;
+    }
+    batch_id_ = batch_->AddPolyline(PositionArray());
+    SyncBatch();
+    curve_node_->SetActive(false);
+}
+
+void NURBSNode::LeaveBatch(){
+    if (batch_id_ < 0) {
+        return;
+    }
+    batch_->RemovePolyline(batch_id_);
+    batch_id_ = -1;
+    curve_node_->SetActive(true);
+}
+
+void NURBSNode::SyncBatch(){
+    if (batch_id_ < 0) {
+        return;
+    }
+    // The batch is drawn in world space.
+    glm::mat4 M = GetTransform().GetLocalToWorldMatrix();
+    PositionArray points;
+    for (const glm::vec3& sample : curve_samples_) {
+        points.push_back(glm::vec3(M * glm::vec4(sample, 1.0f)));
+    }
+    batch_->UpdatePolyline(batch_id_, points);
 }
 
 // Keyboard inputs (WASDZX) to edit the location of control point(s)
 void NURBSNode::Update(double delta_time) {
-  if (curve_type_ == 'R' && curve_being_edited_){ // Regular (move just the selected control point)
-    // Prevent multiple toggle.
-    if (InputManager::GetInstance().IsKeyPressed('W')) {
-        control_pts_[selected_control_point_].y += 0.05;
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('A')) {
-        control_pts_[selected_control_point_].x -= 0.05;
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('S')) {
-        control_pts_[selected_control_point_].y -= 0.05;
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('D')) {
-        control_pts_[selected_control_point_].x += 0.05;
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('Z')){
-        control_pts_[selected_control_point_].z -= 0.05;
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('X')){
-        control_pts_[selected_control_point_].z += 0.05;
-        PlotControlPoints();
-        PlotCurve();
-    }
+  if (!curve_plotted_) {
+    PlotCurve();
   }
-  else if (curve_type_ == 'C' && curve_being_edited_){ // Circle (move all control points on the circle)
-    if (InputManager::GetInstance().IsKeyPressed('W')) {
-        for (int i = 0; i < control_pts_.size(); i++){
-            control_pts_[i].y += 0.05;
-        }
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('A')) {
-        for (int i = 0; i < control_pts_.size(); i++){
-            control_pts_[i].x -= 0.05;
-        }
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('S')) {
-        for (int i = 0; i < control_pts_.size(); i++){
-            control_pts_[i].y -= 0.05;
-        }
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('D')) {
-        for (int i = 0; i < control_pts_.size(); i++){
-            control_pts_[i].x += 0.05;
-        }
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('Z')) {
-        for (int i = 0; i < control_pts_.size(); i++){
-            control_pts_[i].z -= 0.05;
-        }
-        PlotControlPoints();
-        PlotCurve();
-    } else if (InputManager::GetInstance().IsKeyPressed('X')) {
-        for (int i = 0; i < control_pts_.size(); i++){
-            control_pts_[i].x += 0.05;
-        }
-        PlotControlPoints();
-        PlotCurve();
-    }
+  if (!curve_being_edited_) {
+    return;
   }
+  glm::vec3 offset = GetKeyOffset();
+  if (offset == glm::vec3(0.f)) {
+    return;
+  }
+  if (curve_type_ == 'R'){ // Regular (move just the selected control point)
+    BakeTransform();
+    curve_.control_points[selected_control_point_] += offset;
+    PlotControlPoints();
+    UpdateSegments(selected_control_point_, selected_control_point_);
+  }
+  else if (curve_type_ == 'C'){ // Circle (move the whole circle, which keeps its shape)
+    Translate(offset);
+  }
+}
+
+// Index of the control point drawn by node, or -1 if it is not one.
+int NURBSNode::GetControlPointIndex(const SceneNode& node){
+    auto it = std::find(control_point_nodes_.begin(), control_point_nodes_.end(), &node);
+    if (it == control_point_nodes_.end()){
+        return -1;
+    }
+    return it - control_point_nodes_.begin();
 }
 
 // Changes which control point is selected (the user can change the location of the selected control point)   
@@ -381,23 +392,36 @@ void NURBSNode::ChangeSelectedControlPoint(int new_selected_control_point){
 
 // Updates the weights of the CURRENT control points
 void NURBSNode::OnWeightChanged(std::vector<float> new_weights){
-    weights_ = new_weights;
-    PlotCurve();
+    // Only the segments of the weights that changed are re-extracted.
+    int num_weights = static_cast<int>(std::min(new_weights.size(), curve_.weights.size()));
+    int first = num_weights, last = -1;
+    for (int i = 0; i < num_weights; i++) {
+        if (new_weights[i] != curve_.weights[i]) {
+            first = std::min(first, i);
+            last = i;
+        }
+    }
+    curve_.weights = new_weights;
+    if (last >= 0) {
+        UpdateSegments(first, last);
+    }
 }
 
 // Updates the positions of the CURRENT control points // Unused Functions
 void NURBSNode::UpdateControlPointsPositions(std::vector<glm::vec3> new_control_points){
-    control_pts_ = new_control_points;
-    for (int i = 0; i < control_pts_.size(); i++) {
-        control_point_nodes_[i]->GetTransform().SetPosition(control_pts_[i]);
+    ResetTransform();
+    curve_.control_points = new_control_points;
+    for (int i = 0; i < curve_.control_points.size(); i++) {
+        control_point_nodes_[i]->GetTransform().SetPosition(curve_.control_points[i]);
     }
-    PlotCurve();
+    UpdateSegments(0, curve_.control_points.size() - 1);
 }
 
 // Add a NEW control point
 void NURBSNode::AddNewControlPoint(glm::vec3 control_point_loc, float weight, bool clamped_ends){
+    BakeTransform();
     // Add new control point sphere
-    control_pts_.push_back(control_point_loc);
+    curve_.control_points.push_back(control_point_loc);
     auto point_node = make_unique<SceneNode>();
     point_node->GetTransform().SetPosition(control_point_loc);
     point_node->CreateComponent<ShadingComponent>(shader_);
@@ -410,7 +434,7 @@ void NURBSNode::AddNewControlPoint(glm::vec3 control_point_loc, float weight, bo
     AddChild(std::move(point_node));
 
     // Updates weight vec
-    weights_.push_back(weight);
+    curve_.weights.push_back(weight);
 
     CalcKnotVector(clamped_ends, true);
 
@@ -8,15 +8,14 @@
 #include "gloo/VertexObject.hpp"
 #include "gloo/shaders/ShaderProgram.hpp"
 
+#include "PolylineBatchNode.hpp"
+#include "spline/BezierExtraction.hpp"
+#include "spline/SplineTypes.hpp"
+
 namespace GLOO {
 
 enum class NURBSBasis { NURBS };
 
-struct NURBSPoint {
-    glm::vec3 P;
-    glm::vec3 T;
-};
-
 class NURBSNode : public SceneNode {
  public:
     NURBSNode(int degree, std::vector<glm::vec3> control_points, std::vector<float> weights, std::vector<float> knots, NURBSBasis spline_basis, char curve_type, bool curve_being_edited);
@@ -27,11 +26,18 @@ class NURBSNode : public SceneNode {
     // void InitCurveAndControlPoints();
     // void InitCurve();
     void PlotCurve();
+    // Plots the curves of nodes together, batching those that share a
+    // degree and knot vector. Nodes not plotted by then plot themselves on
+    // their first Update.
+    static void PlotCurves(const std::vector<NURBSNode*>& nodes);
     void PlotControlPoints();
     // void PlotTangentLine();
-    float CalcNip(int control_point_i, int degree, float time_u, std::vector<float> knots);
+    float CalcNip(int control_point_i, int degree, float time_u, const std::vector<float>& knots);
     void UpdateControlPointsPositions(std::vector<glm::vec3> new_control_points);
     void ChangeEditStatus(bool curve_being_edited);
+    // While the curve is not being edited, its polyline is drawn by batch
+    // instead of by its own node.
+    void SetBatch(PolylineBatchNode* batch);
     std::vector<glm::vec3> GetControlPointsLocations();
     std::vector<float> GetWeights();
     void AddNewControlPoint(glm::vec3 control_point_loc, float weight, bool clamped_ends);
@@ -40,35 +46,61 @@ class NURBSNode : public SceneNode {
     int GetDegree();
     std::vector<float> CalcKnotVector2(int degree, float knots_size, bool clamped_ends);
     void RemoveControlPoint(int index, bool clamped_ends);
+    // Index of the control point drawn by node, or -1 if it is not one.
+    int GetControlPointIndex(const SceneNode& node);
+    // Rigid edits of the whole curve, about the origin. They only change the
+    // transform of this node, which the polyline and the control point
+    // spheres inherit; the curve is not re-evaluated.
+    void Translate(const glm::vec3& offset);
+    void Rotate(const glm::quat& rotation);
+    void Scale(float factor);
+    // Folds the rigid edits into the control points. Edits of single
+    // control points do this first.
+    void BakeTransform();
     
     // void ChangeControlPointLocation(char key);
 
  private:
     // NURBSPoint EvalCurve(float t);
     void InitCurveAndControlPoints();
+    // Re-extracts the segments of control points first to last and re-plots.
+    void UpdateSegments(int first, int last);
+    // Returns the curve to its untransformed placement.
+    void ResetTransform();
+    void JoinBatch();
+    void LeaveBatch();
+    // Hands the transformed samples to the batch, if the curve is in one.
+    void SyncBatch();
     // void InitCurve();
     // void PlotCurve();
     // void PlotControlPoints();
     // void PlotTangentLine();
     // float CalcNip(int control_point_i, float time_u);
     
-    std::vector<glm::vec3> control_pts_;
-    std::vector<float> knots_;
+    NURBSCurveData curve_;
+    // Re-extracted on every edit; the polyline is sampled from it.
+    RationalBezierCurve bezier_;
     NURBSBasis spline_basis_;
-    int degree_;
-    std::vector<float> weights_;
+    // Last samples of the curve, before its transform.
+    PositionArray curve_samples_;
+    PolylineBatchNode* batch_;
+    // Id of the polyline in batch_, or -1 while the curve draws itself.
+    int batch_id_;
 
     std::shared_ptr<VertexObject> sphere_mesh_;
     std::shared_ptr<VertexObject> curve_polyline_;
     std::shared_ptr<VertexObject> tangent_line_;
     std::shared_ptr<ShaderProgram> shader_;
     std::shared_ptr<ShaderProgram> polyline_shader_;
+    // Draws the polyline while the curve is not in a batch.
+    SceneNode* curve_node_;
     std::vector<SceneNode*> control_point_nodes_;
     int selected_control_point_;
+    bool curve_plotted_;
     char curve_type_;
     bool curve_being_edited_;
 
-    const int N_SUBDIV_ = 50;
+    static const int N_SUBDIV_ = 50;
 };
 }  // namespace GLOO
 
@@ -6,9 +6,11 @@
 
 #include "gloo/SceneNode.hpp"
 #include "gloo/VertexObject.hpp"
+#include "gloo/MeshOptimizer.hpp"
 #include "gloo/shaders/ShaderProgram.hpp"
 
 #include "NURBSNode.hpp"
+#include "spline/BezierExtraction.hpp"
 
 namespace GLOO {
 // struct PatchPoint {
@@ -22,47 +24,54 @@ class NURBSSurface : public SceneNode {
   void Update(double delta_time) override;
   void ChangeSelectedControlPoint(int new_selected_control_point);
   void OnWeightChanged(std::vector<float> new_weights);
+  // Re-tessellates the level of detail on screen; the others follow once
+  // they are selected.
   void UpdateSurface();
+  // Reorders the surface meshes for the vertex cache; they stay optimized
+  // across re-plots. Returns the ACMR of the finest level before and after.
+  MeshOptimizer::Stats OptimizeMesh();
   void PlotControlPoints();
   std::vector<glm::vec3> GetControlPointsLocations();
   std::vector<float> GetWeights();
 
 
  private:
-    int numRows_;
-    int numCols_;
-    std::vector<glm::vec3> control_points_;
-    std::vector<float> weights_;
-    std::vector<float> knotsU_;
-    std::vector<float> knotsV_;
-    int degreeU_;
-    int degreeV_;
+    NURBSSurfaceData surface_;
+    // Re-extracted on every edit; the levels are tessellated from it.
+    RationalBezierSurface bezier_;
     int selected_control_point_;
 
-    int getIndex(int i, int j);
-    NURBSPoint EvalPatch(float u, float v); 
-    float CalcNip(int control_point_i, int degree, float time_u, std::vector<float> knots);
     void PlotSurface();
     void InitControlPoints();
-    // std::vector<float> get_derivative(float u, float v, int order_u, int order_v);
-    float Nip_prime(int control_point_i, int degree, float time_u, std::vector<float> knots);
-    std::vector<std::vector<float>> BasisFunctionsDerivatives(int spanIndex, int degree,  int derivative, const std::vector<float> knotVector, float paramT);
-    int GetKnotSpanIndex(int degree, const std::vector<float> knotVector, float paramT);
-
-    std::vector<std::vector<glm::vec4>> ComputeDerivatives(int degreeU, int degreeV, int derivative, const std::vector<float> knotVectorU, const std::vector<float> knotVectorV, float u, float v, std::vector<std::vector<glm::vec4>> controlPointsHomo);
-    std::vector<std::vector<glm::vec3>> ComputeRationalSurfaceDerivatives(int derivative, float u, float v);
-    float binomial(int n, int k);
-    glm::vec3 Normal(float u, float v);
     //   void PlotPatch();
     //   PatchPoint EvalPatch(float u, float v);
 
     // std::vector<glm::mat4> Gs_;
-    std::shared_ptr<VertexObject> patch_mesh_;
+    // One tessellation per level of detail, finest first.
+    struct SurfaceLevel {
+        int subdivisions;
+        std::shared_ptr<VertexObject> mesh;
+        // The grid topology is fixed, so the indices are built once.
+        IndexArray indices;
+        bool indices_changed;
+        // Vertex slot of each grid point after OptimizeMesh; identity if empty.
+        std::vector<unsigned int> vertex_order;
+        // Control points moved since the level was last tessellated.
+        bool dirty;
+    };
+    void UpdateLevel(size_t level);
+    // Re-extracts the patches of the control points in the given rows and
+    // columns, then updates the surface.
+    void UpdatePatches(int first_row, int last_row, int first_col, int last_col);
+
+    std::vector<SurfaceLevel> levels_;
+    size_t selected_level_;
+    // Scratch arrays keep their capacity between re-plots.
+    PositionArray patch_positions_;
+    NormalArray patch_normals_;
     std::shared_ptr<ShaderProgram> shader_;
     std::shared_ptr<VertexObject> sphere_mesh_;
     std::vector<SceneNode *> control_point_nodes_;
-
-    const int N_SUBDIV_ = 50;
 };
 }  // namespace GLOO
 
@@ -11,11 +11,6 @@
 #include "CurveNode.hpp"
 
 namespace GLOO {
-struct PatchPoint {
-  glm::vec3 P;
-  glm::vec3 N;
-};
-
 class PatchNode : public SceneNode {
  public:
   PatchNode(std::vector<glm::vec3> control_points, SplineBasis spline_basis);
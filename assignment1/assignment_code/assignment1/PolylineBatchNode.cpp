@@ -0,0 +1,70 @@
+#include "PolylineBatchNode.hpp"
+
+#include "gloo/components/MaterialComponent.hpp"
+#include "gloo/components/RenderingComponent.hpp"
+#include "gloo/components/ShadingComponent.hpp"
+#include "gloo/shaders/SimpleShader.hpp"
+
+namespace GLOO {
+PolylineBatchNode::PolylineBatchNode(const glm::vec3& color) : changed_(false) {
+  polylines_obj_ = std::make_shared<VertexObject>(BufferUsage::Dynamic);
+  polylines_obj_->SetRetainCPUData(false);
+  // Empty bounds keep the batch out of the spatial index until it has
+  // polylines.
+  Rebuild();
+
+  CreateComponent<ShadingComponent>(std::make_shared<SimpleShader>());
+  auto& rc = CreateComponent<RenderingComponent>(polylines_obj_);
+  rc.SetDrawMode(DrawMode::LineStrip);
+  auto material = std::make_shared<Material>(color, color, color, 0);
+  CreateComponent<MaterialComponent>(material);
+}
+
+void PolylineBatchNode::Update(double delta_time) {
+  if (changed_) {
+    Rebuild();
+    changed_ = false;
+  }
+}
+
+int PolylineBatchNode::AddPolyline(const PositionArray& points) {
+  int id;
+  if (free_ids_.empty()) {
+    id = static_cast<int>(polylines_.size());
+    polylines_.emplace_back();
+  } else {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  }
+  UpdatePolyline(id, points);
+  return id;
+}
+
+void PolylineBatchNode::UpdatePolyline(int id, const PositionArray& points) {
+  polylines_.at(id) = points;
+  changed_ = true;
+}
+
+void PolylineBatchNode::RemovePolyline(int id) {
+  polylines_.at(id).clear();
+  free_ids_.push_back(id);
+  changed_ = true;
+}
+
+void PolylineBatchNode::Rebuild() {
+  auto positions = make_unique<PositionArray>();
+  auto indices = make_unique<IndexArray>();
+  for (const PositionArray& points : polylines_) {
+    if (points.empty())
+      continue;
+    if (!indices->empty())
+      indices->push_back(VertexArray::kRestartIndex);
+    for (const glm::vec3& point : points) {
+      indices->push_back(static_cast<unsigned int>(positions->size()));
+      positions->push_back(point);
+    }
+  }
+  polylines_obj_->UpdatePositions(std::move(positions));
+  polylines_obj_->UpdateIndices(std::move(indices));
+}
+}  // namespace GLOO
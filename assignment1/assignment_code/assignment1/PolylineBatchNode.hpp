@@ -0,0 +1,36 @@
+#ifndef POLYLINE_BATCH_NODE_H_
+#define POLYLINE_BATCH_NODE_H_
+
+#include <vector>
+
+#include "gloo/SceneNode.hpp"
+#include "gloo/VertexObject.hpp"
+
+namespace GLOO {
+// Polylines of one color merged into a single vertex buffer and drawn as
+// line strips separated by primitive restart, in one draw call per pass.
+// Meant for curves that are not being edited: any change rebuilds the whole
+// buffer, on the next Update.
+class PolylineBatchNode : public SceneNode {
+ public:
+  PolylineBatchNode(const glm::vec3& color);
+  void Update(double delta_time) override;
+
+  // Returns the id of the new polyline.
+  int AddPolyline(const PositionArray& points);
+  void UpdatePolyline(int id, const PositionArray& points);
+  void RemovePolyline(int id);
+
+ private:
+  void Rebuild();
+
+  std::shared_ptr<VertexObject> polylines_obj_;
+  // Points of each polyline by id; removed polylines are empty and their ids
+  // are reused.
+  std::vector<PositionArray> polylines_;
+  std::vector<int> free_ids_;
+  bool changed_;
+};
+}  // namespace GLOO
+
+#endif
@@ -1,8 +1,10 @@
 #include "SplineViewerApp.hpp"
 
 #include <fstream>
+#include <map>
 
 #include "gloo/external.hpp" // take in user inputs
+#include "gloo/InputManager.hpp"
 #include "gloo/cameras/ArcBallCameraNode.hpp"
 #include "gloo/lights/AmbientLight.hpp"
 #include "gloo/lights/PointLight.hpp"
@@ -10,6 +12,7 @@
 #include "gloo/components/LightComponent.hpp"
 
 #include "CurveNode.hpp"
+#include "CurveTemplateNode.hpp"
 #include "PatchNode.hpp"
 #include "Surface.hpp"
 #include "NURBSNode.hpp"
@@ -21,8 +24,9 @@ namespace GLOO {
 
 SplineViewerApp::SplineViewerApp(const std::string& app_name,
                                  glm::ivec2 window_size,
-                                 const std::string& filename)
-    : Application(app_name, window_size), slider_values_(10, 0.0f), filename_(filename) {
+                                 const std::string& filename,
+                                 bool headless)
+    : Application(app_name, window_size, headless), slider_values_(10, 0.0f), filename_(filename) {
 }
 
 void SplineViewerApp::SetupScene() {
@@ -115,6 +119,11 @@ void SplineViewerApp::LoadFile(const std::string& filename, SceneNode& root) {
     auto nurbs_node = make_unique<NURBSNode>(degree, control_points, weights_, knots, NURBSBasis::NURBS, 'R', true);
     nurbs_node_ptr_ = nurbs_node.get();
     root.AddChild(std::move(nurbs_node));
+    // The curve joins the batch whenever a circle is selected instead.
+    auto curve_batch = make_unique<PolylineBatchNode>(glm::vec3(1.f, 1.f, 0.f));
+    curve_batch_ptr_ = curve_batch.get();
+    nurbs_node_ptr_->SetBatch(curve_batch_ptr_);
+    root.AddChild(std::move(curve_batch));
   } else if (spline_type_ == "NURBS surface"){
       int degreeU;
       int degreeV;
@@ -224,6 +233,8 @@ void SplineViewerApp::LoadFile(const std::string& filename, SceneNode& root) {
     auto B_node = make_unique<NURBSNode>(clef_degree, B_line, clef_weights, clef_knots, NURBSBasis::NURBS, 'R', false);
     auto G_node = make_unique<NURBSNode>(clef_degree, G_line, clef_weights, clef_knots, NURBSBasis::NURBS, 'R', false);
     auto E_node = make_unique<NURBSNode>(clef_degree, E_line, clef_weights, clef_knots, NURBSBasis::NURBS, 'R', false);
+    // The staff lines are plotted together, below.
+    std::vector<NURBSNode*> music_nodes = {F_node.get(), D_node.get(), B_node.get(), G_node.get(), E_node.get()};
     root.AddChild(std::move(F_node));
     root.AddChild(std::move(D_node));
     root.AddChild(std::move(B_node));
@@ -235,68 +246,39 @@ void SplineViewerApp::LoadFile(const std::string& filename, SceneNode& root) {
     std::vector<glm::vec3> up_note = {glm::vec3(0.5, 2.95, 0.0), glm::vec3(0.65, 0.5, 0.0), glm::vec3(0.900001, -0.6, 0.0), glm::vec3(-1.15, -0.25, 0.0), glm::vec3(-0.15, 0.7, 0.0), glm::vec3(0.6, 0.1, 0.0)};
     std::vector<glm::vec3> down_note = {glm::vec3(-0.5, -2.65, 0.0), glm::vec3(-0.55, -1.05, 0.0), glm::vec3(-0.849999 ,0.75, 0.0), glm::vec3(1.0, 0.0499999, 0.0), glm::vec3(0.1, -0.55, 0.0), glm::vec3(-0.6, -0.2, 0.0)};
     int note_degree = 3;
-    //auto up_note_node = make_unique<NURBSNode>(note_degree, up_note, note_weights, note_knots, NURBSBasis::NURBS, 'R', false);
-    //auto down_note_node = make_unique<NURBSNode>(note_degree, down_note, note_weights, note_knots, NURBSBasis::NURBS, 'R', false);
+    // Each note is a translated copy of one of two glyphs, stem up below B4
+    // and stem down from B4; the glyphs are tessellated once.
+    const std::map<std::string, float> note_heights = {
+      {"D4", -2.5f}, {"E4", -2.0f}, {"F4", -1.5f}, {"G4", -1.0f},
+      {"A4", -0.5f}, {"B4", 0.0f}, {"C5", 0.5f}, {"D5", 1.0f},
+      {"E5", 1.5f}, {"F5", 2.0f}, {"G5", 2.5f}};
+    NURBSCurveData up_glyph = {note_degree, up_note, note_weights, KnotVector(note_degree, note_knots)};
+    NURBSCurveData down_glyph = {note_degree, down_note, note_weights, KnotVector(note_degree, note_knots)};
+    glm::vec3 note_color(1.f, 1.f, 0.f);
+    auto up_notes = make_unique<CurveTemplateNode>(up_glyph, note_color);
+    auto down_notes = make_unique<CurveTemplateNode>(down_glyph, note_color);
     for (int i = 0; i < notes.size(); i++){
-      std::vector<glm::vec3> note_points;
-      if(notes[i] == "D4"){
-        for (glm::vec3 default_pos : up_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, -2.5, 0.0));
-        }
-      }    
-      if(notes[i] == "E4"){
-        for (glm::vec3 default_pos : up_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, -2.0, 0.0));
-        }
-      }      
-      if(notes[i] == "F4"){
-        for (glm::vec3 default_pos : up_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, -1.5, 0.0));
-        }
-      }
-      if(notes[i] == "G4"){
-        for (glm::vec3 default_pos : up_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, -1.0, 0.0));
-        }
-      }
-      if(notes[i] == "A4"){
-        for (glm::vec3 default_pos : up_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, -0.5, 0.0));
-        }
-      }
-      if(notes[i] == "B4"){
-        for (glm::vec3 default_pos : down_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, 0.0, 0.0));
-        }
-      }
-      if(notes[i] == "C5"){
-        for (glm::vec3 default_pos : down_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, 0.5, 0.0));
-        }
-      }
-      if(notes[i] == "D5"){
-        for (glm::vec3 default_pos : down_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, 1.0, 0.0));
-        }
+      auto it = note_heights.find(notes[i]);
+      if (it == note_heights.end()){
+        continue;
       }
-      if(notes[i] == "E5"){
-        for (glm::vec3 default_pos : down_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, 1.5, 0.0));
-        }
-      }  
-      if(notes[i] == "F5"){
-        for (glm::vec3 default_pos : down_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, 2.0, 0.0));
-        }
+      glm::vec3 offset(-9.0 + i * 2.0, it->second, 0.0);
+      if (it->second < 0.0f){
+        up_notes->AddInstance(offset);
+      } else {
+        down_notes->AddInstance(offset);
       }
-      if(notes[i] == "G5"){
-        for (glm::vec3 default_pos : down_note){
-          note_points.push_back(default_pos + glm::vec3(-9.0 + i * 2.0, 2.5, 0.0));
-        }
-      }                                  
-      auto note_node = make_unique<NURBSNode>(note_degree, note_points, note_weights, note_knots, NURBSBasis::NURBS, 'R', false);
-      root.AddChild(std::move(note_node));
     }
+    root.AddChild(std::move(up_notes));
+    root.AddChild(std::move(down_notes));
+    NURBSNode::PlotCurves(music_nodes);
+    // The staff lines are never edited, so they are drawn in one batch.
+    auto curve_batch = make_unique<PolylineBatchNode>(glm::vec3(1.f, 1.f, 0.f));
+    curve_batch_ptr_ = curve_batch.get();
+    for (NURBSNode* node : music_nodes) {
+      node->SetBatch(curve_batch_ptr_);
+    }
+    root.AddChild(std::move(curve_batch));
   }
 
 }
@@ -306,7 +288,44 @@ void SplineViewerApp::DrawGUI(){
   } else if (spline_type_ == "NURBS surface"){
     DrawSurfaceGUI();
   }
+  // Frames are written to recording_00000.png and up in the working directory.
+  ImGui::Begin("Control Panel");
+  if (ImGui::SmallButton(IsRecording() ? "Stop recording" : "Start recording")){
+    if (IsRecording()){
+      StopRecording();
+    } else {
+      StartRecording("recording_");
+    }
+  }
+  ImGui::End();
+}
+// Clicking (pressing and releasing the left mouse button without dragging the
+// camera) on a control point selects it.
+void SplineViewerApp::PickControlPoint() {
+  auto& input_manager = InputManager::GetInstance();
+  bool pressed = input_manager.IsLeftMousePressed();
+  glm::dvec2 cursor = input_manager.GetCursorPosition();
+  bool clicked = !pressed && left_mouse_was_pressed_ &&
+                 glm::distance(cursor, click_start_) < 3.0;
+  if (pressed && !left_mouse_was_pressed_) {
+    click_start_ = cursor;
+  }
+  left_mouse_was_pressed_ = pressed;
+  if (!clicked) {
+    return;
+  }
+
+  Ray ray = input_manager.GetCursorRay(*scene_->GetActiveCameraPtr());
+  SceneNode* hit = scene_->Pick(ray, [this](const SceneNode& node) {
+    return node.GetParentPtr() == nurbs_node_ptr_ &&
+           nurbs_node_ptr_->GetControlPointIndex(node) >= 0;
+  });
+  if (hit != nullptr) {
+    selected_control_pt = nurbs_node_ptr_->GetControlPointIndex(*hit);
+    nurbs_node_ptr_->ChangeSelectedControlPoint(selected_control_pt);
+  }
 }
+
 void SplineViewerApp::DrawSplineGUI() {
   bool change_control_pt_selection = false; // change which control point is selected
   bool modified = false; // change the selected control point's location
@@ -380,6 +399,7 @@ void SplineViewerApp::DrawSplineGUI() {
   if (change_control_pt_selection){ // change which control point is selected
     nurbs_node_ptr_->ChangeSelectedControlPoint(selected_control_pt);
   }
+  PickControlPoint();
 
   if (modified) { // change the selected control point's location
     nurbs_node_ptr_->OnWeightChanged(weights_);
@@ -404,6 +424,7 @@ void SplineViewerApp::DrawSplineGUI() {
     SceneNode& root = scene_->GetRootNode();
     auto circle = make_unique<NURBSCircle>(glm::vec3(circle_settings_[0], circle_settings_[1], circle_settings_[2]), circle_settings_[3]);
     nurbs_circle_ptrs_.push_back(circle.get());
+    circle->GetNurbsNodePtr()->SetBatch(curve_batch_ptr_);
     root.AddChild(std::move(circle));
   }
 
@@ -446,6 +467,7 @@ void SplineViewerApp::DrawSurfaceGUI() {
   bool change_control_pt_selection = false; // change which control point is selected
   bool modified = false; // change the selected control point's location
   bool print_things = false;
+  bool optimize_mesh = false;
 
   // CONTROL PANEL GUI
   ImGui::Begin("Control Panel");
@@ -461,8 +483,18 @@ void SplineViewerApp::DrawSurfaceGUI() {
   ImGui::Text("");
   ImGui::Text("Print control points info:");
   print_things |= ImGui::SmallButton("Print info!");
+  optimize_mesh |= ImGui::SmallButton("Optimize surface mesh");
+  if (surface_acmr_.acmr_after > 0.0f) {
+    ImGui::SameLine();
+    ImGui::Text("ACMR %.3f -> %.3f", surface_acmr_.acmr_before,
+                surface_acmr_.acmr_after);
+  }
   ImGui::End();
 
+  if (optimize_mesh){ // reorder the surface mesh for the vertex cache
+    surface_acmr_ = surface_node_ptr_->OptimizeMesh();
+  }
+
   if (change_control_pt_selection){ // change which control point is selected
     surface_node_ptr_->ChangeSelectedControlPoint(selected_control_pt);
   }
@@ -5,13 +5,15 @@
 #include "NURBSNode.hpp"
 #include "NURBSCircle.hpp"
 #include "NURBSSurface.hpp"
+#include "PolylineBatchNode.hpp"
 
 namespace GLOO {
 class SplineViewerApp : public Application {
  public:
   SplineViewerApp(const std::string& app_name,
                   glm::ivec2 window_size,
-                  const std::string& filename);
+                  const std::string& filename,
+                  bool headless = false);
   void SetupScene() override;
 
 protected:
@@ -20,13 +22,18 @@ protected:
  private:
   void DrawSplineGUI();
   void DrawSurfaceGUI();
+  void PickControlPoint();
   void LoadFile(const std::string& filename, SceneNode& root);
   std::vector<float> slider_values_;
   std::vector<float> weights_;
   std::vector<glm::vec3> control_points;
   NURBSNode* nurbs_node_ptr_;
   std::vector<NURBSCircle*> nurbs_circle_ptrs_;
+  // Draws the curves that are not being edited.
+  PolylineBatchNode* curve_batch_ptr_ = nullptr;
   int selected_control_pt = 0;
+  bool left_mouse_was_pressed_ = false;
+  glm::dvec2 click_start_;
   int selected_circle = -1;
   float circle_settings_[4] = { 0.0, 0.0, 0.0, 1.0 };
   float control_point_settings_[4] = {0.0, 0.0, 0.0, 1.0};
@@ -34,6 +41,8 @@ protected:
 
 
   NURBSSurface* surface_node_ptr_;
+  // ACMR of the surface mesh around the last optimization, if any.
+  MeshOptimizer::Stats surface_acmr_ = {0.0f, 0.0f};
   // int u8_v = 0;
 
   std::string filename_;
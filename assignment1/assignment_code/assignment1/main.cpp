@@ -6,19 +6,28 @@
 using namespace GLOO;
 
 int main(int argc, char** argv) {
-  if (argc < 2) {
+  if (argc != 2 && !(argc == 4 && std::string(argv[2]) == "--headless")) {
     std::cout << "Usage: " << argv[0]
-              << " SPLINE_FILE where SPLINE_FILE is "
+              << " SPLINE_FILE [--headless OUTPUT_PNG] where SPLINE_FILE is "
                  "relative to assets/assignment1"
               << std::endl;
     return -1;
   }
+  bool headless = argc == 4;
   std::unique_ptr<SplineViewerApp> app =
       make_unique<SplineViewerApp>("Assignment1", glm::ivec2(1440, 900),
-                                   "assignment1/" + std::string(argv[1]));
+                                   "assignment1/" + std::string(argv[1]),
+                                   headless);
 
   app->SetupScene();
 
+  if (headless) {
+    // Render a single frame offscreen and save it.
+    app->Tick(0.0, 0.0);
+    app->CaptureFrame()->SavePNG(argv[3]);
+    return 0;
+  }
+
   using Clock = std::chrono::high_resolution_clock;
   using TimePoint =
       std::chrono::time_point<Clock, std::chrono::duration<double>>;
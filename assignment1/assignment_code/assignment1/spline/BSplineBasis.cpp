@@ -0,0 +1,198 @@
+#include "BSplineBasis.hpp"
+
+#include "FixedDegreeBasis.hpp"
+
+namespace {
+using namespace GLOO;
+
+typedef float (*EvaluateFunction)(int, float, const std::vector<float>&);
+typedef void (*DerivativesFunction)(int,
+                                    float,
+                                    const std::vector<float>&,
+                                    float*);
+
+const EvaluateFunction kEvaluateFunctions[] = {
+    &FixedDegreeBasis<0>::Evaluate, &FixedDegreeBasis<1>::Evaluate,
+    &FixedDegreeBasis<2>::Evaluate, &FixedDegreeBasis<3>::Evaluate,
+    &FixedDegreeBasis<4>::Evaluate, &FixedDegreeBasis<5>::Evaluate};
+
+#define GLOO_DERIVATIVES_ROW(degree)                            \
+  {                                                             \
+    &FixedDegreeBasis<degree>::EvaluateDerivatives<0>,          \
+        &FixedDegreeBasis<degree>::EvaluateDerivatives<1>,      \
+        &FixedDegreeBasis<degree>::EvaluateDerivatives<2>       \
+  }
+const DerivativesFunction
+    kDerivativesFunctions[][BSplineBasis::kMaxFixedDerivative + 1] = {
+        GLOO_DERIVATIVES_ROW(0), GLOO_DERIVATIVES_ROW(1),
+        GLOO_DERIVATIVES_ROW(2), GLOO_DERIVATIVES_ROW(3),
+        GLOO_DERIVATIVES_ROW(4), GLOO_DERIVATIVES_ROW(5)};
+
+typedef void (*NonZeroFunction)(int, float, const KnotVector&, float*);
+typedef void (*KnotVectorDerivativesFunction)(int,
+                                              float,
+                                              const KnotVector&,
+                                              float*);
+
+const NonZeroFunction kNonZeroFunctions[] = {
+    &FixedDegreeBasis<0>::EvaluateNonZero,
+    &FixedDegreeBasis<1>::EvaluateNonZero,
+    &FixedDegreeBasis<2>::EvaluateNonZero,
+    &FixedDegreeBasis<3>::EvaluateNonZero,
+    &FixedDegreeBasis<4>::EvaluateNonZero,
+    &FixedDegreeBasis<5>::EvaluateNonZero};
+
+const KnotVectorDerivativesFunction
+    kKnotVectorDerivativesFunctions[][BSplineBasis::kMaxFixedDerivative + 1] =
+        {GLOO_DERIVATIVES_ROW(0), GLOO_DERIVATIVES_ROW(1),
+         GLOO_DERIVATIVES_ROW(2), GLOO_DERIVATIVES_ROW(3),
+         GLOO_DERIVATIVES_ROW(4), GLOO_DERIVATIVES_ROW(5)};
+#undef GLOO_DERIVATIVES_ROW
+
+static_assert(sizeof(kEvaluateFunctions) / sizeof(kEvaluateFunctions[0]) ==
+                  BSplineBasis::kMaxFixedDegree + 1,
+              "One function per specialized degree");
+static_assert(sizeof(kDerivativesFunctions) /
+                      sizeof(kDerivativesFunctions[0]) ==
+                  BSplineBasis::kMaxFixedDegree + 1,
+              "One row per specialized degree");
+static_assert(sizeof(kNonZeroFunctions) / sizeof(kNonZeroFunctions[0]) ==
+                  BSplineBasis::kMaxFixedDegree + 1,
+              "One function per specialized degree");
+static_assert(sizeof(kKnotVectorDerivativesFunctions) /
+                      sizeof(kKnotVectorDerivativesFunctions[0]) ==
+                  BSplineBasis::kMaxFixedDegree + 1,
+              "One row per specialized degree");
+
+// EvaluateBasisDerivatives for degrees without a FixedDegreeBasis.
+template <class Knots, class InverseLength>
+void EvaluateDerivativesGeneric(int span,
+                                int degree,
+                                int derivative,
+                                const Knots& knots,
+                                InverseLength inverse_length,
+                                float u,
+                                float* derivatives) {
+  int order = degree + 1;
+  std::vector<float> ndu(order * order);
+  std::vector<float> a(2 * order);
+  std::vector<float> left(order);
+  std::vector<float> right(order);
+  EvaluateBasisDerivatives(span, degree, derivative, u, knots, inverse_length,
+                           ndu.data(), a.data(), left.data(), right.data(),
+                           derivatives);
+}
+}  // namespace
+
+namespace GLOO {
+std::vector<float> BSplineBasis::UniformKnots(int degree,
+                                              int num_intervals,
+                                              bool clamped) {
+  std::vector<float> knots(num_intervals + 1);
+  for (int i = 0; i <= num_intervals; i++) {
+    knots[i] = static_cast<float>(i) / num_intervals;
+  }
+  if (clamped) {
+    for (int i = 0; i <= degree; i++) {
+      knots[i] = 0.0f;
+      knots[num_intervals - i] = 1.0f;
+    }
+  }
+  return knots;
+}
+
+float BSplineBasis::Evaluate(int i,
+                             int degree,
+                             float u,
+                             const std::vector<float>& knots) {
+  if (degree >= 0 && degree <= kMaxFixedDegree)
+    return kEvaluateFunctions[degree](i, u, knots);
+  std::vector<float> N(degree + 1);
+  return EvaluateBasisFunction(i, degree, u, knots, N.data());
+}
+
+// https://github.com/BIMCoderLiang/LNLib/blob/f715aaf05b7dfaa8b11f3508d9f507cbbe3ec860/src/LNLib/Algorithm/Polynomials.cpp#L11
+int BSplineBasis::FindSpan(int degree,
+                           const std::vector<float>& knots,
+                           float u) {
+  int n = static_cast<int>(knots.size()) - degree - 2;
+  if (u >= knots[n + 1]) {
+    return n;
+  }
+  if (u <= knots[degree]) {
+    return degree;
+  }
+
+  int low = 0;
+  int high = n + 1;
+  int mid = (low + high) / 2;
+  while (u < knots[mid] || u >= knots[mid + 1]) {
+    if (u < knots[mid]) {
+      high = mid;
+    } else {
+      low = mid;
+    }
+    mid = (low + high) / 2;
+  }
+  return mid;
+}
+
+std::vector<std::vector<float>> BSplineBasis::EvaluateDerivatives(
+    int span,
+    int degree,
+    int derivative,
+    const std::vector<float>& knots,
+    float u) {
+  std::vector<float> flat((derivative + 1) * (degree + 1));
+  EvaluateDerivatives(span, degree, derivative, knots, u, flat.data());
+  std::vector<std::vector<float>> derivatives(derivative + 1);
+  for (int k = 0; k <= derivative; k++) {
+    derivatives[k].assign(flat.begin() + k * (degree + 1),
+                          flat.begin() + (k + 1) * (degree + 1));
+  }
+  return derivatives;
+}
+
+void BSplineBasis::EvaluateDerivatives(int span,
+                                       int degree,
+                                       int derivative,
+                                       const std::vector<float>& knots,
+                                       float u,
+                                       float* derivatives) {
+  if (degree >= 0 && degree <= kMaxFixedDegree && derivative >= 0 &&
+      derivative <= kMaxFixedDerivative) {
+    kDerivativesFunctions[degree][derivative](span, u, knots, derivatives);
+  } else {
+    EvaluateDerivativesGeneric(span, degree, derivative, knots,
+                               DividedInverseLength(knots), u, derivatives);
+  }
+}
+
+void BSplineBasis::EvaluateNonZero(int span,
+                                   const KnotVector& knots,
+                                   float u,
+                                   float* N) {
+  int degree = knots.GetDegree();
+  if (degree <= kMaxFixedDegree) {
+    kNonZeroFunctions[degree](span, u, knots, N);
+  } else {
+    EvaluateDerivativesGeneric(span, degree, 0, knots,
+                               PrecomputedInverseLength(knots), u, N);
+  }
+}
+
+void BSplineBasis::EvaluateDerivatives(int span,
+                                       int derivative,
+                                       const KnotVector& knots,
+                                       float u,
+                                       float* derivatives) {
+  int degree = knots.GetDegree();
+  if (degree <= kMaxFixedDegree && derivative <= kMaxFixedDerivative) {
+    kKnotVectorDerivativesFunctions[degree][derivative](span, u, knots,
+                                                        derivatives);
+  } else {
+    EvaluateDerivativesGeneric(span, degree, derivative, knots,
+                               PrecomputedInverseLength(knots), u, derivatives);
+  }
+}
+}  // namespace GLOO
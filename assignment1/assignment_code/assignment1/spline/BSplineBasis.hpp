@@ -0,0 +1,66 @@
+#ifndef B_SPLINE_BASIS_H_
+#define B_SPLINE_BASIS_H_
+
+#include <vector>
+
+#include "KnotVector.hpp"
+
+namespace GLOO {
+// B-spline basis functions over a knot vector, following The NURBS Book.
+class BSplineBasis {
+ public:
+  // Degrees up to this one run code specialized with FixedDegreeBasis.
+  static const int kMaxFixedDegree = 5;
+  // Derivative orders up to this one are specialized as well.
+  static const int kMaxFixedDerivative = 2;
+
+  // num_intervals + 1 evenly spaced knots over [0, 1]. Clamped vectors
+  // repeat the end knots degree + 1 times, so that the curve goes through
+  // its end points.
+  static std::vector<float> UniformKnots(int degree,
+                                         int num_intervals,
+                                         bool clamped);
+  // N_{i,degree}(u), including the clamped end points.
+  static float Evaluate(int i,
+                        int degree,
+                        float u,
+                        const std::vector<float>& knots);
+  // Index of the knot span [knots[span], knots[span + 1]) holding u,
+  // clamped to the valid range.
+  static int FindSpan(int degree, const std::vector<float>& knots, float u);
+  // The degree + 1 functions non-zero in span and their derivatives up to
+  // the given order: result[k][j] is the k-th derivative of
+  // N_{span - degree + j}.
+  static std::vector<std::vector<float>> EvaluateDerivatives(
+      int span,
+      int degree,
+      int derivative,
+      const std::vector<float>& knots,
+      float u);
+  // Same as above into derivatives[k * (degree + 1) + j], which must hold
+  // (derivative + 1) * (degree + 1) values. Orders above degree are zero.
+  static void EvaluateDerivatives(int span,
+                                  int degree,
+                                  int derivative,
+                                  const std::vector<float>& knots,
+                                  float u,
+                                  float* derivatives);
+
+  // The KnotVector overloads below multiply by its inverse span lengths
+  // instead of dividing.
+  //
+  // The degree + 1 functions non-zero in span (Algorithm A2.2): N[j] is
+  // N_{span - degree + j}.
+  static void EvaluateNonZero(int span,
+                              const KnotVector& knots,
+                              float u,
+                              float* N);
+  static void EvaluateDerivatives(int span,
+                                  int derivative,
+                                  const KnotVector& knots,
+                                  float u,
+                                  float* derivatives);
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,339 @@
+#include "BezierExtraction.hpp"
+
+#include <algorithm>
+
+namespace {
+using namespace GLOO;
+
+float Binomial(int n, int k) {
+  if (k == 0 || k == n)
+    return 1.0f;
+  return Binomial(n - 1, k - 1) + Binomial(n - 1, k);
+}
+
+// M[b * (degree + 1) + j] is the coefficient of s^j in the Bernstein
+// polynomial B_b(s) = C(degree, b) s^b (1 - s)^(degree - b).
+std::vector<float> BernsteinToPower(int degree) {
+  int order = degree + 1;
+  std::vector<float> M(order * order, 0.0f);
+  for (int b = 0; b <= degree; b++) {
+    for (int j = b; j <= degree; j++) {
+      float sign = (j - b) % 2 == 0 ? 1.0f : -1.0f;
+      M[b * order + j] =
+          sign * Binomial(degree, b) * Binomial(degree - b, j - b);
+    }
+  }
+  return M;
+}
+
+void ExtractSegment(const NURBSCurveData& curve,
+                    const std::vector<float>& M,
+                    int e,
+                    RationalBezierCurve& bezier) {
+  const BezierOperators& extraction = bezier.extraction;
+  int order = extraction.degree + 1;
+  int first = extraction.first_control_points[e];
+  const float* C = &extraction.operators[e * order * order];
+  glm::vec4* Q = &bezier.control_points[e * order];
+  for (int a = 0; a < order; a++) {
+    Q[a] = glm::vec4(0.0f);
+    for (int i = 0; i < order; i++) {
+      Q[a] += C[a * order + i] * Homogeneous(curve.control_points[first + i],
+                                             curve.weights[first + i]);
+    }
+  }
+  glm::vec4* A = &bezier.power_coefficients[e * order];
+  for (int j = 0; j < order; j++) {
+    A[j] = glm::vec4(0.0f);
+    for (int b = 0; b <= j; b++) {
+      A[j] += M[b * order + j] * Q[b];
+    }
+  }
+}
+
+void ExtractPatch(const NURBSSurfaceData& surface,
+                  const std::vector<float>& Mu,
+                  const std::vector<float>& Mv,
+                  int eu,
+                  int ev,
+                  RationalBezierSurface& bezier) {
+  const BezierOperators& ext_u = bezier.extraction_u;
+  const BezierOperators& ext_v = bezier.extraction_v;
+  int order_u = ext_u.degree + 1;
+  int order_v = ext_v.degree + 1;
+  int first_row = ext_u.first_control_points[eu];
+  int first_col = ext_v.first_control_points[ev];
+  const float* Cu = &ext_u.operators[eu * order_u * order_u];
+  const float* Cv = &ext_v.operators[ev * order_v * order_v];
+  size_t offset = (eu * ext_v.GetNumSegments() + ev) *
+                  static_cast<size_t>(order_u * order_v);
+  glm::vec4* Q = &bezier.control_points[offset];
+  glm::vec4* A = &bezier.power_coefficients[offset];
+
+  // Along u first, then along v, so each patch costs
+  // O(order^3) instead of O(order^4).
+  std::vector<glm::vec4> T(order_u * order_v, glm::vec4(0.0f));
+  for (int a = 0; a < order_u; a++) {
+    for (int i = 0; i < order_u; i++) {
+      float c = Cu[a * order_u + i];
+      if (c == 0.0f)
+        continue;
+      for (int j = 0; j < order_v; j++) {
+        int k = surface.GetIndex(first_row + i, first_col + j);
+        T[a * order_v + j] +=
+            c * Homogeneous(surface.control_points[k], surface.weights[k]);
+      }
+    }
+  }
+  for (int a = 0; a < order_u; a++) {
+    for (int b = 0; b < order_v; b++) {
+      Q[a * order_v + b] = glm::vec4(0.0f);
+      for (int j = 0; j < order_v; j++) {
+        Q[a * order_v + b] += Cv[b * order_v + j] * T[a * order_v + j];
+      }
+    }
+  }
+
+  // The same two steps take the Bernstein basis to the power basis.
+  for (int a = 0; a < order_u; a++) {
+    for (int j = 0; j < order_v; j++) {
+      T[a * order_v + j] = glm::vec4(0.0f);
+      for (int b = 0; b <= j; b++) {
+        T[a * order_v + j] += Mv[b * order_v + j] * Q[a * order_v + b];
+      }
+    }
+  }
+  for (int i = 0; i < order_u; i++) {
+    for (int j = 0; j < order_v; j++) {
+      A[i * order_v + j] = glm::vec4(0.0f);
+      for (int a = 0; a <= i; a++) {
+        A[i * order_v + j] += Mu[a * order_u + i] * T[a * order_v + j];
+      }
+    }
+  }
+}
+
+bool ActsOn(const BezierOperators& extraction, int e, int first, int last) {
+  int f = extraction.first_control_points[e];
+  return f <= last && f + extraction.degree >= first;
+}
+}  // namespace
+
+namespace GLOO {
+BezierOperators BezierExtraction::ComputeOperators(
+    int degree,
+    const std::vector<float>& knots) {
+  BezierOperators extraction;
+  extraction.degree = degree;
+  int order = degree + 1;
+  int num_control_points = static_cast<int>(knots.size()) - order;
+  // d[l] holds the weights of the degree + 1 control points in the l-th
+  // point of the de Boor triangle.
+  std::vector<double> d(order * order);
+  for (int k = degree; k < num_control_points; k++) {
+    double a = knots[k];
+    double c = knots[k + 1];
+    if (a >= c)
+      continue;
+    if (extraction.breakpoints.empty())
+      extraction.breakpoints.push_back(knots[k]);
+    extraction.breakpoints.push_back(knots[k + 1]);
+    extraction.first_control_points.push_back(k - degree);
+
+    // Bezier point b is the blossom of the segment at (a, ..., a, c, ..., c)
+    // with b copies of c.
+    for (int b = 0; b <= degree; b++) {
+      std::fill(d.begin(), d.end(), 0.0);
+      for (int l = 0; l < order; l++) {
+        d[l * order + l] = 1.0;
+      }
+      for (int r = 1; r <= degree; r++) {
+        double x = r <= degree - b ? a : c;
+        for (int l = degree; l >= r; l--) {
+          int j = k - degree + l;
+          double alpha =
+              (x - knots[j]) / (knots[j + degree + 1 - r] - knots[j]);
+          for (int i = 0; i < order; i++) {
+            d[l * order + i] = (1.0 - alpha) * d[(l - 1) * order + i] +
+                               alpha * d[l * order + i];
+          }
+        }
+      }
+      for (int i = 0; i < order; i++) {
+        extraction.operators.push_back(
+            static_cast<float>(d[degree * order + i]));
+      }
+    }
+  }
+  return extraction;
+}
+
+void BezierExtraction::ExtractCurve(const NURBSCurveData& curve,
+                                    RationalBezierCurve& bezier) {
+  bezier.extraction = ComputeOperators(curve.degree, curve.knots.GetKnots());
+  // Knot vectors longer than degree + 1 plus the number of control points
+  // would give segments without control points.
+  BezierOperators& extraction = bezier.extraction;
+  int order = curve.degree + 1;
+  int num_control_points = static_cast<int>(curve.control_points.size());
+  while (extraction.GetNumSegments() > 0 &&
+         extraction.first_control_points.back() + order > num_control_points) {
+    extraction.first_control_points.pop_back();
+    extraction.breakpoints.pop_back();
+    extraction.operators.resize(extraction.operators.size() - order * order);
+  }
+  if (extraction.GetNumSegments() == 0)
+    extraction.breakpoints.clear();
+  size_t size = extraction.GetNumSegments() * static_cast<size_t>(order);
+  bezier.control_points.resize(size);
+  bezier.power_coefficients.resize(size);
+  UpdateCurve(curve, 0, static_cast<int>(curve.control_points.size()) - 1,
+              bezier);
+}
+
+void BezierExtraction::UpdateCurve(const NURBSCurveData& curve,
+                                   int first,
+                                   int last,
+                                   RationalBezierCurve& bezier) {
+  std::vector<float> M = BernsteinToPower(curve.degree);
+  for (int e = 0; e < bezier.extraction.GetNumSegments(); e++) {
+    if (ActsOn(bezier.extraction, e, first, last))
+      ExtractSegment(curve, M, e, bezier);
+  }
+}
+
+NURBSPoint BezierExtraction::EvalCurve(const RationalBezierCurve& bezier,
+                                       float t) {
+  if (bezier.extraction.GetNumSegments() == 0)
+    return {glm::vec3(0.0f), glm::vec3(0.0f)};
+  float s;
+  int e = FindSegment(bezier.extraction, t, s);
+  return EvalSegment(bezier, e, s);
+}
+
+NURBSPoint BezierExtraction::EvalSegment(const RationalBezierCurve& bezier,
+                                         int e,
+                                         float s) {
+  int degree = bezier.extraction.degree;
+  const glm::vec4* A = &bezier.power_coefficients[e * (degree + 1)];
+  // Horner's rule for the point and its derivative.
+  glm::vec4 point = A[degree];
+  glm::vec4 derivative(0.0f);
+  for (int j = degree - 1; j >= 0; j--) {
+    derivative = derivative * s + point;
+    point = point * s + A[j];
+  }
+
+  NURBSPoint curve_point;
+  curve_point.P = glm::vec3(point) / point.w;
+  glm::vec3 tangent =
+      (glm::vec3(derivative) - derivative.w * curve_point.P) / point.w;
+  float length = glm::length(tangent);
+  curve_point.T = length > 0.0f ? tangent / length : glm::vec3(0.0f);
+  return curve_point;
+}
+
+void BezierExtraction::ExtractSurface(const NURBSSurfaceData& surface,
+                                      RationalBezierSurface& bezier) {
+  bezier.extraction_u =
+      ComputeOperators(surface.degree_u, surface.knots_u.GetKnots());
+  bezier.extraction_v =
+      ComputeOperators(surface.degree_v, surface.knots_v.GetKnots());
+  size_t size = bezier.extraction_u.GetNumSegments() *
+                bezier.extraction_v.GetNumSegments() *
+                static_cast<size_t>((surface.degree_u + 1) *
+                                    (surface.degree_v + 1));
+  bezier.control_points.resize(size);
+  bezier.power_coefficients.resize(size);
+  UpdateSurface(surface, 0, surface.num_rows - 1, 0, surface.num_cols - 1,
+                bezier);
+}
+
+void BezierExtraction::UpdateSurface(const NURBSSurfaceData& surface,
+                                     int first_row,
+                                     int last_row,
+                                     int first_col,
+                                     int last_col,
+                                     RationalBezierSurface& bezier) {
+  std::vector<float> Mu = BernsteinToPower(surface.degree_u);
+  std::vector<float> Mv = BernsteinToPower(surface.degree_v);
+  for (int eu = 0; eu < bezier.extraction_u.GetNumSegments(); eu++) {
+    if (!ActsOn(bezier.extraction_u, eu, first_row, last_row))
+      continue;
+    for (int ev = 0; ev < bezier.extraction_v.GetNumSegments(); ev++) {
+      if (ActsOn(bezier.extraction_v, ev, first_col, last_col))
+        ExtractPatch(surface, Mu, Mv, eu, ev, bezier);
+    }
+  }
+}
+
+NURBSPoint BezierExtraction::EvalSurface(const RationalBezierSurface& bezier,
+                                         float u,
+                                         float v) {
+  if (bezier.extraction_u.GetNumSegments() == 0 ||
+      bezier.extraction_v.GetNumSegments() == 0)
+    return {glm::vec3(0.0f), glm::vec3(0.0f)};
+  float s, t;
+  int eu = FindSegment(bezier.extraction_u, u, s);
+  int ev = FindSegment(bezier.extraction_v, v, t);
+  return EvalPatch(bezier, eu, ev, s, t);
+}
+
+NURBSPoint BezierExtraction::EvalPatch(const RationalBezierSurface& bezier,
+                                       int eu,
+                                       int ev,
+                                       float s,
+                                       float t) {
+  int degree_u = bezier.extraction_u.degree;
+  int degree_v = bezier.extraction_v.degree;
+  int order_v = degree_v + 1;
+  size_t offset = (eu * bezier.extraction_v.GetNumSegments() + ev) *
+                  static_cast<size_t>((degree_u + 1) * order_v);
+  const glm::vec4* A = &bezier.power_coefficients[offset];
+
+  // Horner's rule along v for each power of s, then along u.
+  glm::vec4 point(0.0f), d_s(0.0f), d_t(0.0f);
+  for (int i = degree_u; i >= 0; i--) {
+    const glm::vec4* row = &A[i * order_v];
+    glm::vec4 row_point = row[degree_v];
+    glm::vec4 row_d_t(0.0f);
+    for (int j = degree_v - 1; j >= 0; j--) {
+      row_d_t = row_d_t * t + row_point;
+      row_point = row_point * t + row[j];
+    }
+    d_s = d_s * s + point;
+    point = point * s + row_point;
+    d_t = d_t * s + row_d_t;
+  }
+
+  // The local parameters only scale the derivatives, which does not change
+  // the normal.
+  NURBSPoint surface_point;
+  surface_point.P = glm::vec3(point) / point.w;
+  glm::vec3 dP_du = (glm::vec3(d_s) - d_s.w * surface_point.P) / point.w;
+  glm::vec3 dP_dv = (glm::vec3(d_t) - d_t.w * surface_point.P) / point.w;
+  surface_point.T = -glm::normalize(glm::cross(dP_du, dP_dv));
+  return surface_point;
+}
+
+int BezierExtraction::FindSegment(const BezierOperators& extraction,
+                                  float x,
+                                  float& s) {
+  const std::vector<float>& breakpoints = extraction.breakpoints;
+  int last = extraction.GetNumSegments() - 1;
+  int e;
+  if (x <= breakpoints.front()) {
+    e = 0;
+  } else if (x >= breakpoints.back()) {
+    e = last;
+  } else {
+    e = static_cast<int>(std::upper_bound(breakpoints.begin(),
+                                          breakpoints.end(), x) -
+                         breakpoints.begin()) -
+        1;
+  }
+  s = (x - breakpoints[e]) / (breakpoints[e + 1] - breakpoints[e]);
+  s = std::min(std::max(s, 0.0f), 1.0f);
+  return e;
+}
+}  // namespace GLOO
@@ -0,0 +1,102 @@
+#ifndef BEZIER_EXTRACTION_H_
+#define BEZIER_EXTRACTION_H_
+
+#include <vector>
+
+#include "SplineTypes.hpp"
+
+namespace GLOO {
+// Splits a B-spline basis at its distinct knots. On segment e, the Bezier
+// control points are Q_a = sum_i C_e[a][i] P_{first + i}, where first is
+// first_control_points[e]. The operators C_e depend only on the degree and
+// the knots, so moving control points only needs the products again.
+struct BezierOperators {
+  int degree;
+  // Segment e covers [breakpoints[e], breakpoints[e + 1]].
+  std::vector<float> breakpoints;
+  std::vector<int> first_control_points;
+  // (degree + 1)^2 entries per segment, C_e[a][i] at a * (degree + 1) + i.
+  std::vector<float> operators;
+
+  int GetNumSegments() const {
+    return static_cast<int>(first_control_points.size());
+  }
+};
+
+// A NURBS curve as rational Bezier segments. Points are homogeneous,
+// (w * P, w).
+struct RationalBezierCurve {
+  BezierOperators extraction;
+  // degree + 1 Bezier control points per segment.
+  std::vector<glm::vec4> control_points;
+  // The same segments in the power basis of the local parameter
+  // s in [0, 1], so a sample costs degree + 1 multiply-adds.
+  std::vector<glm::vec4> power_coefficients;
+};
+
+// A NURBS surface as rational Bezier patches, patch (eu, ev) at
+// eu * num_segments_v + ev. Inside a patch, point (a, b) is at
+// a * (degree_v + 1) + b, with a along u.
+struct RationalBezierSurface {
+  BezierOperators extraction_u;
+  BezierOperators extraction_v;
+  std::vector<glm::vec4> control_points;
+  std::vector<glm::vec4> power_coefficients;
+};
+
+// Converts NURBS to rational Bezier pieces once per edit, after which every
+// sample costs the same whatever the length of the knot vectors.
+class BezierExtraction {
+ public:
+  // The operators of the segments in [knots[degree], knots[m - degree]].
+  // Clamped and unclamped knot vectors both work.
+  static BezierOperators ComputeOperators(int degree,
+                                          const std::vector<float>& knots);
+
+  // Recomputes everything; needed after the knots or the number of control
+  // points change.
+  static void ExtractCurve(const NURBSCurveData& curve,
+                           RationalBezierCurve& bezier);
+  // Re-extracts only the segments that control points first to last
+  // (inclusive) act on, after they moved or changed weight.
+  static void UpdateCurve(const NURBSCurveData& curve,
+                          int first,
+                          int last,
+                          RationalBezierCurve& bezier);
+  // Point and unit tangent at t.
+  static NURBSPoint EvalCurve(const RationalBezierCurve& bezier, float t);
+  // Same as above on segment e at local parameter s in [0, 1].
+  static NURBSPoint EvalSegment(const RationalBezierCurve& bezier,
+                                int e,
+                                float s);
+
+  static void ExtractSurface(const NURBSSurfaceData& surface,
+                             RationalBezierSurface& bezier);
+  // Re-extracts only the patches that the control points in rows
+  // first_row to last_row and columns first_col to last_col act on.
+  static void UpdateSurface(const NURBSSurfaceData& surface,
+                            int first_row,
+                            int last_row,
+                            int first_col,
+                            int last_col,
+                            RationalBezierSurface& bezier);
+  // Point and unit normal at (u, v), with the normal oriented as in
+  // NURBSEvaluator::SurfaceNormal.
+  static NURBSPoint EvalSurface(const RationalBezierSurface& bezier,
+                                float u,
+                                float v);
+  static NURBSPoint EvalPatch(const RationalBezierSurface& bezier,
+                              int eu,
+                              int ev,
+                              float s,
+                              float t);
+
+  // Segment holding x, clamped to the valid range, and the local
+  // parameter of x on it.
+  static int FindSegment(const BezierOperators& extraction,
+                         float x,
+                         float& s);
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,51 @@
+#include "CubicSpline.hpp"
+
+namespace GLOO {
+glm::mat4 CubicSpline::GetBasisMatrix(SplineBasis basis) {
+  if (basis == SplineBasis::Bezier) {
+    return glm::mat4(1, 0, 0, 0, -3, 3, 0, 0, 3, -6, 3, 0, -1, 3, -3, 1);
+  }
+  return glm::mat4(1 / 6.0, 2 / 3.0, 1 / 6.0, 0.0, -1 / 2.0, 0.0, 1 / 2.0, 0,
+                   1 / 2.0, -1, 1 / 2.0, 0, -1 / 6.0, 1 / 2.0, -1 / 2.0,
+                   1 / 6.0);
+}
+
+glm::mat4x3 CubicSpline::ConvertBasis(const glm::mat4x3& G,
+                                      SplineBasis from,
+                                      SplineBasis to) {
+  return G * GetBasisMatrix(from) * glm::inverse(GetBasisMatrix(to));
+}
+
+CurvePoint CubicSpline::EvalCurve(const glm::mat4x3& G,
+                                  SplineBasis basis,
+                                  float t) {
+  glm::mat4 B = GetBasisMatrix(basis);
+  glm::vec4 monomial = glm::vec4(1, t, t * t, t * t * t);
+  glm::vec3 P = G * B * monomial;
+  glm::vec4 d_monomial = glm::vec4(0, 1, 2 * t, 3 * t * t);
+  glm::vec3 T = G * B * d_monomial;
+  return CurvePoint{P, T};
+}
+
+PatchPoint CubicSpline::EvalPatch(const std::vector<glm::mat4>& Gs,
+                                  SplineBasis basis,
+                                  float u,
+                                  float v) {
+  glm::mat4 B = GetBasisMatrix(basis);
+  glm::mat4 B_transpose = glm::transpose(B);
+
+  glm::vec4 u_vec = glm::vec4(1, u, u * u, u * u * u);
+  glm::vec4 v_vec = glm::vec4(1, v, v * v, v * v * v);
+  glm::vec4 d_u_vec = glm::vec4(0, 1, 2 * u, 3 * u * u);
+  glm::vec4 d_v_vec = glm::vec4(0, 1, 2 * v, 3 * v * v);
+
+  glm::vec3 P, dP_du, dP_dv;
+  for (int c = 0; c < 3; c++) {
+    P[c] = glm::dot(u_vec * B_transpose * Gs[c] * B, v_vec);
+    dP_du[c] = glm::dot(d_u_vec * B_transpose * Gs[c] * B, v_vec);
+    dP_dv[c] = glm::dot(u_vec * B_transpose * Gs[c] * B, d_v_vec);
+  }
+  glm::vec3 N = -glm::normalize(glm::cross(dP_du, dP_dv));
+  return PatchPoint{P, N};
+}
+}  // namespace GLOO
@@ -0,0 +1,30 @@
+#ifndef CUBIC_SPLINE_H_
+#define CUBIC_SPLINE_H_
+
+#include <vector>
+
+#include "SplineTypes.hpp"
+
+namespace GLOO {
+// Cubic Bezier and uniform B-spline curves and patches in matrix form.
+class CubicSpline {
+ public:
+  // Maps the monomials (1, t, t^2, t^3) to the weights of the four control
+  // points.
+  static glm::mat4 GetBasisMatrix(SplineBasis basis);
+  // Control points in basis to that trace the same curve as G in basis
+  // from.
+  static glm::mat4x3 ConvertBasis(const glm::mat4x3& G,
+                                  SplineBasis from,
+                                  SplineBasis to);
+  // G holds the four control points as columns.
+  static CurvePoint EvalCurve(const glm::mat4x3& G, SplineBasis basis, float t);
+  // Gs holds the x, y and z coordinates of the 4x4 control points.
+  static PatchPoint EvalPatch(const std::vector<glm::mat4>& Gs,
+                              SplineBasis basis,
+                              float u,
+                              float v);
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,118 @@
+#include "CurveBatch.hpp"
+
+#include <algorithm>
+
+#include "BSplineBasis.hpp"
+
+namespace GLOO {
+CurveBatch::CurveBatch(const KnotVector& knots, int num_control_points)
+    : knots_(knots), num_control_points_(num_control_points), num_curves_(0) {
+}
+
+bool CurveBatch::Accepts(const NURBSCurveData& curve) const {
+  return curve.degree == knots_.GetDegree() &&
+         static_cast<int>(curve.control_points.size()) ==
+             num_control_points_ &&
+         curve.knots.GetKnots() == knots_.GetKnots();
+}
+
+int CurveBatch::Add(const NURBSCurveData& curve) {
+  int index = num_curves_++;
+  if (index % kLanes == 0) {
+    // Unused lanes get unit weights so that they divide harmlessly.
+    size_t block_size = num_control_points_ * 4 * kLanes;
+    coordinates_.resize(coordinates_.size() + block_size, 0.0f);
+    int block = index / kLanes;
+    for (int i = 0; i < num_control_points_; i++) {
+      float* lanes = GetLanes(block, i);
+      std::fill(lanes + 3 * kLanes, lanes + 4 * kLanes, 1.0f);
+    }
+  }
+  Set(index, curve);
+  return index;
+}
+
+void CurveBatch::Set(int index, const NURBSCurveData& curve) {
+  int block = index / kLanes;
+  int lane = index % kLanes;
+  for (int i = 0; i < num_control_points_; i++) {
+    float* lanes = GetLanes(block, i);
+    float w = curve.weights[i];
+    lanes[lane] = w * curve.control_points[i].x;
+    lanes[kLanes + lane] = w * curve.control_points[i].y;
+    lanes[2 * kLanes + lane] = w * curve.control_points[i].z;
+    lanes[3 * kLanes + lane] = w;
+  }
+}
+
+void CurveBatch::Sample(int num_samples,
+                        std::vector<glm::vec3>& positions) const {
+  positions.resize(num_curves_ * num_samples);
+  if (num_curves_ == 0)
+    return;
+  int degree = knots_.GetDegree();
+  int order = degree + 1;
+  float start = knots_[degree];
+  float end = knots_[knots_.GetKnots().size() - degree - 1];
+  float interval_length = end - start;
+
+  // The basis functions of a sample are shared by every curve.
+  std::vector<int> spans(num_samples);
+  std::vector<float> basis(num_samples * order);
+  for (int i = 0; i < num_samples; i++) {
+    float t = (static_cast<float>(i) / (num_samples - 1)) * interval_length +
+              start;
+    spans[i] = knots_.FindSpan(t);
+    BSplineBasis::EvaluateNonZero(spans[i], knots_, t, &basis[i * order]);
+  }
+
+  int num_blocks = (num_curves_ + kLanes - 1) / kLanes;
+  for (int block = 0; block < num_blocks; block++) {
+    int num_lanes = std::min(kLanes, num_curves_ - block * kLanes);
+    glm::vec3* block_positions = &positions[block * kLanes * num_samples];
+    for (int i = 0; i < num_samples; i++) {
+      float sum[4 * kLanes] = {};
+      const float* N = &basis[i * order];
+      for (int j = 0; j < order; j++) {
+        const float* lanes = GetLanes(block, spans[i] - degree + j);
+        for (int l = 0; l < 4 * kLanes; l++) {
+          sum[l] += N[j] * lanes[l];
+        }
+      }
+      float inverse_w[kLanes];
+      for (int l = 0; l < kLanes; l++) {
+        inverse_w[l] = 1.0f / sum[3 * kLanes + l];
+      }
+      for (int l = 0; l < num_lanes; l++) {
+        block_positions[l * num_samples + i] =
+            glm::vec3(sum[l], sum[kLanes + l], sum[2 * kLanes + l]) *
+            inverse_w[l];
+      }
+    }
+  }
+}
+
+std::vector<CurveBatch> CurveBatch::Group(
+    const std::vector<const NURBSCurveData*>& curves,
+    std::vector<std::pair<int, int>>& slots) {
+  std::vector<CurveBatch> batches;
+  slots.assign(curves.size(), std::make_pair(-1, -1));
+  for (size_t i = 0; i < curves.size(); i++) {
+    const NURBSCurveData& curve = *curves[i];
+    int num_control_points = static_cast<int>(curve.control_points.size());
+    int num_knots = static_cast<int>(curve.knots.GetKnots().size());
+    if (num_control_points <= curve.degree ||
+        num_control_points != num_knots - curve.degree - 1)
+      continue;
+    size_t b = 0;
+    while (b < batches.size() && !batches[b].Accepts(curve)) {
+      b++;
+    }
+    if (b == batches.size()) {
+      batches.push_back(CurveBatch(curve.knots, num_control_points));
+    }
+    slots[i] = std::make_pair(static_cast<int>(b), batches[b].Add(curve));
+  }
+  return batches;
+}
+}  // namespace GLOO
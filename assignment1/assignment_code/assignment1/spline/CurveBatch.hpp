@@ -0,0 +1,61 @@
+#ifndef CURVE_BATCH_H_
+#define CURVE_BATCH_H_
+
+#include <utility>
+#include <vector>
+
+#include "SplineTypes.hpp"
+
+namespace GLOO {
+// Curves sharing a degree, a knot vector and a number of control points.
+// Homogeneous control points are stored structure-of-arrays, kLanes curves
+// per block, so the basis functions are evaluated once per sample and the
+// weighted sums over a block are plain loops the compiler vectorizes.
+class CurveBatch {
+ public:
+  static const int kLanes = 8;
+
+  CurveBatch(const KnotVector& knots, int num_control_points);
+
+  // Whether curve has this batch's degree, knots and number of control
+  // points.
+  bool Accepts(const NURBSCurveData& curve) const;
+  // Appends curve and returns its index in the batch.
+  int Add(const NURBSCurveData& curve);
+  // Replaces the control points and weights of curve index.
+  void Set(int index, const NURBSCurveData& curve);
+  int GetNumCurves() const {
+    return num_curves_;
+  }
+
+  // num_samples points per curve at the parameters of
+  // SplineTessellator::SampleCurve; those of curve c start at
+  // c * num_samples.
+  void Sample(int num_samples, std::vector<glm::vec3>& positions) const;
+
+  // Splits curves into batches. Curve i becomes curve slots[i].second of
+  // batch slots[i].first, or gets -1 in both if it has too few control
+  // points for its knot vector to be evaluated.
+  static std::vector<CurveBatch> Group(
+      const std::vector<const NURBSCurveData*>& curves,
+      std::vector<std::pair<int, int>>& slots);
+
+ private:
+  float* GetLanes(int block, int control_point) {
+    return &coordinates_[(block * num_control_points_ + control_point) * 4 *
+                         kLanes];
+  }
+  const float* GetLanes(int block, int control_point) const {
+    return &coordinates_[(block * num_control_points_ + control_point) * 4 *
+                         kLanes];
+  }
+
+  KnotVector knots_;
+  int num_control_points_;
+  int num_curves_;
+  // Per block, per control point: kLanes each of wx, wy, wz and w.
+  std::vector<float> coordinates_;
+};
+}  // namespace GLOO
+
+#endif
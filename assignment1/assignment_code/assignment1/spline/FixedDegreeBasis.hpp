@@ -0,0 +1,246 @@
+#ifndef FIXED_DEGREE_BASIS_H_
+#define FIXED_DEGREE_BASIS_H_
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "KnotVector.hpp"
+
+namespace GLOO {
+// Adapted from https://www.codeproject.com/Articles/1095142/Generate-and-understand-NURBS-curves
+// N_{i,degree}(u) by dynamic programming over the triangular table of
+// lower-degree functions, using N as scratch for degree + 1 values. Shared
+// by BSplineBasis::Evaluate and FixedDegreeBasis<Degree>::Evaluate, where
+// the constant degree lets the compiler unroll the loops once inlined.
+inline float EvaluateBasisFunction(int i,
+                                   int degree,
+                                   float u,
+                                   const std::vector<float>& knots,
+                                   float* N) {
+  int p = degree;
+  const std::vector<float>& U = knots;
+
+  int m = static_cast<int>(U.size()) - 1;
+  if ((i == 0 && u == U[0]) || (i == (m - p - 1) && u == U[m])) {
+    return 1.0f;
+  }
+  if (u < U[i] || u >= U[i + p + 1]) {  // avoid division by 0
+    return 0.0f;
+  }
+
+  for (int j = 0; j <= p; j++) {
+    N[j] = (u >= U[i + j] && u < U[i + j + 1]) ? 1.0f : 0.0f;
+  }
+
+  for (int k = 1; k <= p; k++) {
+    float saved;
+    if (N[0] == 0) {
+      saved = 0.0f;
+    } else {
+      saved = ((u - U[i]) * N[0]) / (U[i + k] - U[i]);
+    }
+    for (int j = 0; j < p - k + 1; j++) {
+      float u_left = U[i + j + 1];
+      float u_right = U[i + j + k + 1];
+      if (N[j + 1] == 0) {
+        N[j] = saved;
+        saved = 0.0f;
+      } else {
+        float temp = N[j + 1] / (u_right - u_left);
+        N[j] = saved + (u_right - u) * temp;
+        saved = (u - u_left) * temp;
+      }
+    }
+  }
+  return N[0];
+}
+
+// Algorithm A2.3 of The NURBS Book into derivatives[k * (degree + 1) + j],
+// the k-th derivative of N_{span - degree + j}; orders above the degree are
+// zero. inverse_length(first, length) gives 1 / (knots[first + length] -
+// knots[first]), so callers choose between dividing and precomputed inverse
+// lengths. Scratch: ndu holds (degree + 1)^2 values, a 2 * (degree + 1)
+// zeroed values, left and right degree + 1 values each. Shared by
+// BSplineBasis::EvaluateDerivatives and FixedDegreeBasis, as above.
+template <class Knots, class InverseLength>
+inline void EvaluateBasisDerivatives(int span,
+                                     int degree,
+                                     int derivative,
+                                     float u,
+                                     const Knots& knots,
+                                     InverseLength inverse_length,
+                                     float* ndu,
+                                     float* a,
+                                     float* left,
+                                     float* right,
+                                     float* derivatives) {
+  int order = degree + 1;
+  // ndu[r * order + j] for r <= j is a basis function of degree j. The knot
+  // span from knots[span + 1 - j + r] of length j, which the book keeps
+  // below the diagonal, comes from inverse_length instead.
+  ndu[0] = 1.0f;
+  for (int j = 1; j <= degree; j++) {
+    left[j] = u - knots[span + 1 - j];
+    right[j] = knots[span + j] - u;
+    float saved = 0.0f;
+    for (int r = 0; r < j; r++) {
+      float temp =
+          ndu[r * order + j - 1] * inverse_length(span + 1 - j + r, j);
+      ndu[r * order + j] = saved + right[r + 1] * temp;
+      saved = left[j - r] * temp;
+    }
+    ndu[j * order + j] = saved;
+  }
+  for (int j = 0; j <= degree; j++) {
+    derivatives[j] = ndu[j * order + degree];
+  }
+
+  int top = std::min(derivative, degree);
+  for (int r = 0; r <= degree; r++) {
+    float* a_prev = a;
+    float* a_next = a + order;
+    a_prev[0] = 1.0f;
+    // The span below the diagonal at (pk + 1, rk + j) starts at
+    // knots[first + j].
+    int first = span - degree + r;
+    for (int k = 1; k <= top; k++) {
+      float d = 0.0f;
+      int rk = r - k;
+      int pk = degree - k;
+      if (r >= k) {
+        a_next[0] = a_prev[0] * inverse_length(first, pk + 1);
+        d = a_next[0] * ndu[rk * order + pk];
+      }
+      int j1 = rk >= -1 ? 1 : -rk;
+      int j2 = r - 1 <= pk ? k - 1 : degree - r;
+      for (int j = j1; j <= j2; j++) {
+        a_next[j] =
+            (a_prev[j] - a_prev[j - 1]) * inverse_length(first + j, pk + 1);
+        d += a_next[j] * ndu[(rk + j) * order + pk];
+      }
+      if (r <= pk) {
+        a_next[k] = -a_prev[k - 1] * inverse_length(first + k, pk + 1);
+        d += a_next[k] * ndu[r * order + pk];
+      }
+      derivatives[k * order + r] = d;
+      std::swap(a_prev, a_next);
+    }
+  }
+
+  float factor = static_cast<float>(degree);
+  for (int k = 1; k <= derivative; k++) {
+    for (int j = 0; j <= degree; j++) {
+      derivatives[k * order + j] =
+          k <= top ? derivatives[k * order + j] * factor : 0.0f;
+    }
+    factor *= degree - k;
+  }
+}
+
+// 1 / (knots[first + length] - knots[first]) by division, for knots
+// without precomputed inverse lengths.
+class DividedInverseLength {
+ public:
+  explicit DividedInverseLength(const std::vector<float>& knots)
+      : knots_(knots) {
+  }
+  float operator()(int first, int length) const {
+    return 1.0f / (knots_[first + length] - knots_[first]);
+  }
+
+ private:
+  const std::vector<float>& knots_;
+};
+
+// KnotVector::GetInverseLength as a function object.
+class PrecomputedInverseLength {
+ public:
+  explicit PrecomputedInverseLength(const KnotVector& knots) : knots_(knots) {
+  }
+  float operator()(int first, int length) const {
+    return knots_.GetInverseLength(first, length);
+  }
+
+ private:
+  const KnotVector& knots_;
+};
+
+// The algorithms of BSplineBasis with the degree known at compile time.
+// Scratch space lives in std::array and every loop has a constant trip
+// count, so the compiler unrolls them. BSplineBasis dispatches here for
+// degrees up to BSplineBasis::kMaxFixedDegree.
+template <int Degree>
+class FixedDegreeBasis {
+ public:
+  static const int kOrder = Degree + 1;
+
+  // N_{i,Degree}(u), as BSplineBasis::Evaluate.
+  static float Evaluate(int i, float u, const std::vector<float>& knots) {
+    std::array<float, kOrder> N;
+    return EvaluateBasisFunction(i, Degree, u, knots, N.data());
+  }
+
+  // The kOrder functions non-zero in span (Algorithm A2.2), N[j] being
+  // N_{span - Degree + j}.
+  static void EvaluateNonZero(int span,
+                              float u,
+                              const KnotVector& knots,
+                              float* N) {
+    std::array<float, kOrder> left, right;
+    N[0] = 1.0f;
+    for (int j = 1; j <= Degree; j++) {
+      left[j] = u - knots[span + 1 - j];
+      right[j] = knots[span + j] - u;
+      float saved = 0.0f;
+      for (int r = 0; r < j; r++) {
+        // right[r + 1] + left[j - r] is the knot span below.
+        float temp = N[r] * knots.GetInverseLength(span + 1 - j + r, j);
+        N[r] = saved + right[r + 1] * temp;
+        saved = left[j - r] * temp;
+      }
+      N[j] = saved;
+    }
+  }
+
+  // Algorithm A2.3 into derivatives[k * kOrder + j], the k-th derivative
+  // of N_{span - Degree + j}. Orders above Degree are zero.
+  template <int Derivative>
+  static void EvaluateDerivatives(int span,
+                                  float u,
+                                  const std::vector<float>& knots,
+                                  float* derivatives) {
+    Scratch scratch;
+    EvaluateBasisDerivatives(span, Degree, Derivative, u, knots,
+                             DividedInverseLength(knots), scratch.ndu.data(),
+                             scratch.a.data(), scratch.left.data(),
+                             scratch.right.data(), derivatives);
+  }
+
+  // Same as above, multiplying by the inverse span lengths of knots.
+  template <int Derivative>
+  static void EvaluateDerivatives(int span,
+                                  float u,
+                                  const KnotVector& knots,
+                                  float* derivatives) {
+    Scratch scratch;
+    EvaluateBasisDerivatives(span, Degree, Derivative, u, knots,
+                             PrecomputedInverseLength(knots),
+                             scratch.ndu.data(), scratch.a.data(),
+                             scratch.left.data(), scratch.right.data(),
+                             derivatives);
+  }
+
+ private:
+  // For EvaluateBasisDerivatives.
+  struct Scratch {
+    std::array<float, kOrder * kOrder> ndu;
+    std::array<float, 2 * kOrder> a{};
+    std::array<float, kOrder> left;
+    std::array<float, kOrder> right;
+  };
+};
+}  // namespace GLOO
+
+#endif
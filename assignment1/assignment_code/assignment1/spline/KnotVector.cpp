@@ -0,0 +1,122 @@
+#include "KnotVector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+// Whether knots[first] to knots[last] are evenly spaced and increasing.
+bool IsEvenlySpaced(const std::vector<float>& knots, int first, int last) {
+  if (last - first < 1)
+    return true;
+  float step = (knots[last] - knots[first]) / (last - first);
+  if (step <= 0.0f)
+    return false;
+  // Knots built as i / n are not exactly i steps apart.
+  float tolerance = 1e-4f * step;
+  for (int i = first + 1; i <= last; i++) {
+    if (std::abs(knots[i] - knots[i - 1] - step) > tolerance)
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+namespace GLOO {
+KnotVector::KnotVector()
+    : degree_(0),
+      kind_(Kind::General),
+      uniform_first_(0),
+      uniform_last_(0),
+      inverse_step_(0.0f) {
+}
+
+KnotVector::KnotVector(int degree, std::vector<float> knots)
+    : degree_(degree),
+      kind_(Kind::General),
+      knots_(std::move(knots)),
+      uniform_first_(0),
+      uniform_last_(0),
+      inverse_step_(0.0f) {
+  int num_knots = static_cast<int>(knots_.size());
+  inverse_lengths_.resize(std::max(degree_, 1) * knots_.size(), 0.0f);
+  for (int length = 1; length <= degree_; length++) {
+    for (int first = 0; first + length < num_knots; first++) {
+      float span_length = knots_[first + length] - knots_[first];
+      if (span_length > 0.0f)
+        inverse_lengths_[(length - 1) * num_knots + first] = 1.0f / span_length;
+    }
+  }
+  Classify();
+}
+
+void KnotVector::Classify() {
+  int num_knots = static_cast<int>(knots_.size());
+  // The last span holding parameters is [knots[n], knots[n + 1]].
+  int n = num_knots - degree_ - 2;
+  if (n < degree_)
+    return;
+
+  if (IsEvenlySpaced(knots_, 0, num_knots - 1)) {
+    kind_ = Kind::Uniform;
+    uniform_first_ = degree_;
+    uniform_last_ = n + 1;
+  } else {
+    for (int i = 1; i <= degree_; i++) {
+      if (knots_[i] != knots_[0] || knots_[num_knots - 1 - i] != knots_.back())
+        return;
+    }
+    if (knots_[degree_ + 1] <= knots_[degree_] || knots_[n] >= knots_[n + 1] ||
+        !IsEvenlySpaced(knots_, degree_ + 1, n))
+      return;
+    kind_ = Kind::ClampedUniform;
+    uniform_first_ = degree_ + 1;
+    uniform_last_ = n;
+  }
+  if (uniform_last_ > uniform_first_) {
+    inverse_step_ = (uniform_last_ - uniform_first_) /
+                    (knots_[uniform_last_] - knots_[uniform_first_]);
+  }
+}
+
+int KnotVector::FindSpan(float u) const {
+  int n = static_cast<int>(knots_.size()) - degree_ - 2;
+  if (u >= knots_[n + 1]) {
+    return n;
+  }
+  if (u <= knots_[degree_]) {
+    return degree_;
+  }
+
+  if (kind_ == Kind::General) {
+    int low = 0;
+    int high = n + 1;
+    int mid = (low + high) / 2;
+    while (u < knots_[mid] || u >= knots_[mid + 1]) {
+      if (u < knots_[mid]) {
+        high = mid;
+      } else {
+        low = mid;
+      }
+      mid = (low + high) / 2;
+    }
+    return mid;
+  }
+
+  if (u < knots_[uniform_first_])
+    return uniform_first_ - 1;
+  if (u >= knots_[uniform_last_])
+    return uniform_last_;
+  int span = uniform_first_ + static_cast<int>((u - knots_[uniform_first_]) *
+                                               inverse_step_);
+  span = std::min(std::max(span, uniform_first_), uniform_last_ - 1);
+  // Rounding can land a span off.
+  while (u < knots_[span]) {
+    span--;
+  }
+  while (u >= knots_[span + 1]) {
+    span++;
+  }
+  return span;
+}
+}  // namespace GLOO
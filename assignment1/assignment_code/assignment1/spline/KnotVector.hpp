@@ -0,0 +1,62 @@
+#ifndef KNOT_VECTOR_H_
+#define KNOT_VECTOR_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace GLOO {
+// A knot vector that knows its shape. Uniform and clamped uniform vectors,
+// the only ones NURBSNode builds, find knot spans with arithmetic instead of
+// a search. Every vector keeps the inverse span lengths that the basis
+// recursions would otherwise divide by.
+class KnotVector {
+ public:
+  enum class Kind {
+    // All knots evenly spaced.
+    Uniform,
+    // degree + 1 equal knots at each end, evenly spaced ones in between.
+    // The two end spans may be longer, as BSplineBasis::UniformKnots
+    // makes them.
+    ClampedUniform,
+    General
+  };
+
+  KnotVector();
+  KnotVector(int degree, std::vector<float> knots);
+
+  int GetDegree() const {
+    return degree_;
+  }
+  Kind GetKind() const {
+    return kind_;
+  }
+  const std::vector<float>& GetKnots() const {
+    return knots_;
+  }
+  float operator[](size_t i) const {
+    return knots_[i];
+  }
+
+  // Same result as BSplineBasis::FindSpan.
+  int FindSpan(float u) const;
+  // 1 / (knots[first + length] - knots[first]), or 0 if the knots are
+  // equal, for length from 1 to the degree.
+  float GetInverseLength(int first, int length) const {
+    return inverse_lengths_[(length - 1) * knots_.size() + first];
+  }
+
+ private:
+  void Classify();
+
+  int degree_;
+  Kind kind_;
+  std::vector<float> knots_;
+  std::vector<float> inverse_lengths_;
+  // Knots uniform_first_ to uniform_last_ are inverse_step_^-1 apart.
+  int uniform_first_;
+  int uniform_last_;
+  float inverse_step_;
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,197 @@
+#include "NURBSEvaluator.hpp"
+
+#include <algorithm>
+
+#include "BSplineBasis.hpp"
+
+namespace {
+using namespace GLOO;
+
+float Binomial(int n, int k) {
+  if (k == 0 || k == n)
+    return 1.0f;
+  return Binomial(n - 1, k - 1) + Binomial(n - 1, k);
+}
+
+// Room for basis function values, on the stack unless the degree is above
+// those BSplineBasis specializes.
+class BasisScratch {
+ public:
+  explicit BasisScratch(size_t size) {
+    if (size > kStackSize)
+      heap_.resize(size);
+  }
+
+  float* Get() {
+    return heap_.empty() ? stack_ : heap_.data();
+  }
+
+ private:
+  static const size_t kStackSize =
+      (BSplineBasis::kMaxFixedDerivative + 1) *
+      (BSplineBasis::kMaxFixedDegree + 1);
+  float stack_[kStackSize];
+  std::vector<float> heap_;
+};
+}  // namespace
+
+namespace GLOO {
+// Evaluates the curve at time t. In many textbooks, the variable "u" is used
+// instead. Only the degree + 1 basis functions of the span holding t are
+// non-zero.
+NURBSPoint NURBSEvaluator::EvalCurve(const NURBSCurveData& curve, float t) {
+  NURBSPoint curve_point;
+  curve_point.P = glm::vec3(0.0f);
+  curve_point.T = glm::vec3(0.0f);
+
+  int degree = curve.degree;
+  int span = curve.knots.FindSpan(t);
+  BasisScratch scratch(degree + 1);
+  float* N = scratch.Get();
+  BSplineBasis::EvaluateNonZero(span, curve.knots, t, N);
+
+  float rational_weight = 0.0f;  // the denominator
+  for (int j = 0; j <= degree; j++) {
+    int i = span - degree + j;
+    float weight = N[j] * curve.weights[i];
+    rational_weight += weight;
+    curve_point.P += curve.control_points[i] * weight;
+  }
+  curve_point.P /= rational_weight;
+  return curve_point;
+}
+
+// Formula from Wikipedia and Springer - The NURBS Book
+NURBSPoint NURBSEvaluator::EvalSurface(const NURBSSurfaceData& surface,
+                                       float u,
+                                       float v) {
+  NURBSPoint surface_point;
+  surface_point.P = glm::vec3(0.0f);
+
+  int degree_u = surface.degree_u;
+  int degree_v = surface.degree_v;
+  int u_span = surface.knots_u.FindSpan(u);
+  int v_span = surface.knots_v.FindSpan(v);
+  BasisScratch scratch_u(degree_u + 1);
+  BasisScratch scratch_v(degree_v + 1);
+  float* Nu = scratch_u.Get();
+  float* Nv = scratch_v.Get();
+  BSplineBasis::EvaluateNonZero(u_span, surface.knots_u, u, Nu);
+  BSplineBasis::EvaluateNonZero(v_span, surface.knots_v, v, Nv);
+
+  float rational_weight = 0.0f;
+  for (int r = 0; r <= degree_u; r++) {
+    for (int s = 0; s <= degree_v; s++) {
+      int k = surface.GetIndex(u_span - degree_u + r, v_span - degree_v + s);
+      float weight = Nu[r] * Nv[s] * surface.weights[k];
+      rational_weight += weight;
+      surface_point.P += surface.control_points[k] * weight;
+    }
+  }
+  if (rational_weight != 0) {
+    surface_point.P /= rational_weight;
+  }
+
+  surface_point.T = SurfaceNormal(surface, u, v);
+  return surface_point;
+}
+
+//https://github.com/BIMCoderLiang/LNLib/blob/f715aaf05b7dfaa8b11f3508d9f507cbbe3ec860/src/LNLib/include/BsplineSurface.h#L24
+std::vector<std::vector<glm::vec4>>
+NURBSEvaluator::HomogeneousSurfaceDerivatives(const NURBSSurfaceData& surface,
+                                              int derivative,
+                                              float u,
+                                              float v) {
+  int degree_u = surface.degree_u;
+  int degree_v = surface.degree_v;
+  std::vector<std::vector<glm::vec4>> derivatives(
+      derivative + 1, std::vector<glm::vec4>(derivative + 1));
+
+  // Nu[k * (degree_u + 1) + r] is the k-th derivative of the r-th function.
+  int u_span = surface.knots_u.FindSpan(u);
+  BasisScratch scratch_u((derivative + 1) * (degree_u + 1));
+  float* Nu = scratch_u.Get();
+  BSplineBasis::EvaluateDerivatives(u_span, derivative, surface.knots_u, u,
+                                    Nu);
+  int v_span = surface.knots_v.FindSpan(v);
+  BasisScratch scratch_v((derivative + 1) * (degree_v + 1));
+  float* Nv = scratch_v.Get();
+  BSplineBasis::EvaluateDerivatives(v_span, derivative, surface.knots_v, v,
+                                    Nv);
+
+  int du = std::min(derivative, degree_u);
+  int dv = std::min(derivative, degree_v);
+
+  std::vector<glm::vec4> temp(degree_v + 1);
+  for (int k = 0; k <= du; k++) {
+    for (int s = 0; s <= degree_v; s++) {
+      temp[s] = glm::vec4(0.0f);
+      for (int r = 0; r <= degree_u; r++) {
+        int index =
+            surface.GetIndex(u_span - degree_u + r, v_span - degree_v + s);
+        temp[s] += Nu[k * (degree_u + 1) + r] *
+                   Homogeneous(surface.control_points[index],
+                               surface.weights[index]);
+      }
+    }
+    int dd = std::min(derivative, dv);
+    for (int l = 0; l <= dd; l++) {
+      for (int s = 0; s <= degree_v; s++) {
+        derivatives[k][l] += Nv[l * (degree_v + 1) + s] * temp[s];
+      }
+    }
+  }
+  return derivatives;
+}
+
+std::vector<std::vector<glm::vec3>> NURBSEvaluator::RationalSurfaceDerivatives(
+    const NURBSSurfaceData& surface,
+    int derivative,
+    float u,
+    float v) {
+  std::vector<std::vector<glm::vec4>> ders =
+      HomogeneousSurfaceDerivatives(surface, derivative, u, v);
+  std::vector<std::vector<glm::vec3>> Aders(
+      derivative + 1, std::vector<glm::vec3>(derivative + 1));
+  std::vector<std::vector<float>> wders(derivative + 1,
+                                        std::vector<float>(derivative + 1));
+  for (size_t i = 0; i < ders.size(); i++) {
+    for (size_t j = 0; j < ders[0].size(); j++) {
+      Aders[i][j] = glm::vec3(ders[i][j]);
+      wders[i][j] = ders[i][j][3];  // w coordinate
+    }
+  }
+
+  std::vector<std::vector<glm::vec3>> derivatives(
+      derivative + 1, std::vector<glm::vec3>(derivative + 1));
+  for (int k = 0; k <= derivative; k++) {
+    for (int l = 0; l <= derivative - k; l++) {
+      glm::vec3 d = Aders[k][l];
+      for (int j = 1; j <= l; j++) {
+        d -= Binomial(l, j) * wders[0][j] * derivatives[k][l - j];
+      }
+      for (int i = 1; i <= k; i++) {
+        d -= Binomial(k, i) * wders[i][0] * derivatives[k - i][l];
+
+        glm::vec3 d2(0.0f);
+        for (int j = 1; j <= l; j++) {
+          d2 += Binomial(l, j) * wders[i][j] * derivatives[k - i][l - j];
+        }
+        d -= Binomial(k, i) * d2;
+      }
+      derivatives[k][l] = d / wders[0][0];
+    }
+  }
+  return derivatives;
+}
+
+glm::vec3 NURBSEvaluator::SurfaceNormal(const NURBSSurfaceData& surface,
+                                        float u,
+                                        float v) {
+  std::vector<std::vector<glm::vec3>> derivatives =
+      RationalSurfaceDerivatives(surface, 1, u, v);
+  glm::vec3 dP_du = derivatives[1][0];
+  glm::vec3 dP_dv = derivatives[0][1];
+  return -glm::normalize(glm::cross(dP_du, dP_dv));
+}
+}  // namespace GLOO
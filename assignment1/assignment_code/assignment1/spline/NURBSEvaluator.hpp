@@ -0,0 +1,39 @@
+#ifndef NURBS_EVALUATOR_H_
+#define NURBS_EVALUATOR_H_
+
+#include <vector>
+
+#include "SplineTypes.hpp"
+
+namespace GLOO {
+// Point evaluation of rational B-spline curves and surfaces.
+class NURBSEvaluator {
+ public:
+  // Point at t; the tangent is left zero.
+  static NURBSPoint EvalCurve(const NURBSCurveData& curve, float t);
+  // Point and unit normal at (u, v).
+  static NURBSPoint EvalSurface(const NURBSSurfaceData& surface,
+                                float u,
+                                float v);
+  // result[k][l] is the derivative of order k in u and l in v, for
+  // k + l <= derivative (Algorithm A4.4 of The NURBS Book).
+  static std::vector<std::vector<glm::vec3>> RationalSurfaceDerivatives(
+      const NURBSSurfaceData& surface,
+      int derivative,
+      float u,
+      float v);
+  static glm::vec3 SurfaceNormal(const NURBSSurfaceData& surface,
+                                 float u,
+                                 float v);
+
+ private:
+  // Derivatives of the homogeneous surface (Algorithm A3.6).
+  static std::vector<std::vector<glm::vec4>> HomogeneousSurfaceDerivatives(
+      const NURBSSurfaceData& surface,
+      int derivative,
+      float u,
+      float v);
+};
+}  // namespace GLOO
+
+#endif
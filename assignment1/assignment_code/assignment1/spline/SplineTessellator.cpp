@@ -0,0 +1,171 @@
+#include "SplineTessellator.hpp"
+
+#include <algorithm>
+
+#include "CubicSpline.hpp"
+#include "NURBSEvaluator.hpp"
+
+namespace GLOO {
+void SplineTessellator::SampleCurve(const NURBSCurveData& curve,
+                                    int num_samples,
+                                    std::vector<glm::vec3>& positions) {
+  float start = curve.knots[curve.degree];
+  float end = curve.knots[curve.knots.GetKnots().size() - curve.degree - 1];
+  float interval_length = end - start;
+  positions.resize(num_samples);
+  for (int i = 0; i < num_samples; i++) {
+    float t = (static_cast<float>(i) / (num_samples - 1)) * interval_length +
+              start;
+    positions[i] = NURBSEvaluator::EvalCurve(curve, t).P;
+  }
+}
+
+void SplineTessellator::SampleCurve(const RationalBezierCurve& curve,
+                                    int num_samples,
+                                    std::vector<glm::vec3>& positions) {
+  const BezierOperators& extraction = curve.extraction;
+  if (extraction.GetNumSegments() == 0) {
+    positions.assign(num_samples, glm::vec3(0.0f));
+    return;
+  }
+  float start = extraction.breakpoints.front();
+  float end = extraction.breakpoints.back();
+  float interval_length = end - start;
+  positions.resize(num_samples);
+  // Samples increase, so the segment only ever moves forward.
+  int e = 0;
+  for (int i = 0; i < num_samples; i++) {
+    float t = (static_cast<float>(i) / (num_samples - 1)) * interval_length +
+              start;
+    while (e + 1 < extraction.GetNumSegments() &&
+           t > extraction.breakpoints[e + 1]) {
+      e++;
+    }
+    float s = (t - extraction.breakpoints[e]) /
+              (extraction.breakpoints[e + 1] - extraction.breakpoints[e]);
+    s = std::min(std::max(s, 0.0f), 1.0f);
+    positions[i] = BezierExtraction::EvalSegment(curve, e, s).P;
+  }
+}
+
+void SplineTessellator::SampleCubicCurve(const glm::mat4x3& G,
+                                         SplineBasis basis,
+                                         int num_samples,
+                                         std::vector<glm::vec3>& positions) {
+  positions.resize(num_samples);
+  for (int i = 0; i < num_samples; i++) {
+    float t = static_cast<float>(i) / (num_samples - 1);
+    positions[i] = CubicSpline::EvalCurve(G, basis, t).P;
+  }
+}
+
+std::vector<unsigned int> SplineTessellator::GetPolylineIndices(
+    int num_points) {
+  std::vector<unsigned int> indices;
+  for (int i = 0; i + 1 < num_points; i++) {
+    indices.push_back(i);
+    indices.push_back(i + 1);
+  }
+  return indices;
+}
+
+void SplineTessellator::TessellateSurface(
+    const NURBSSurfaceData& surface,
+    int subdivisions,
+    const std::vector<unsigned int>& vertex_order,
+    std::vector<glm::vec3>& positions,
+    std::vector<glm::vec3>& normals) {
+  int grid_size = subdivisions + 1;
+  positions.resize(grid_size * grid_size);
+  normals.resize(grid_size * grid_size);
+  float width_triangle = 1.0f / subdivisions;
+  for (int i = 0; i < grid_size; i++) {
+    for (int j = 0; j < grid_size; j++) {
+      NURBSPoint p = NURBSEvaluator::EvalSurface(surface, i * width_triangle,
+                                                 j * width_triangle);
+      size_t k = i * grid_size + j;
+      if (!vertex_order.empty())
+        k = vertex_order[k];
+      positions[k] = p.P;
+      normals[k] = p.T;
+    }
+  }
+}
+
+void SplineTessellator::TessellateSurface(
+    const RationalBezierSurface& surface,
+    int subdivisions,
+    const std::vector<unsigned int>& vertex_order,
+    std::vector<glm::vec3>& positions,
+    std::vector<glm::vec3>& normals) {
+  int grid_size = subdivisions + 1;
+  positions.resize(grid_size * grid_size);
+  normals.resize(grid_size * grid_size);
+  if (surface.extraction_u.GetNumSegments() == 0 ||
+      surface.extraction_v.GetNumSegments() == 0) {
+    std::fill(positions.begin(), positions.end(), glm::vec3(0.0f));
+    std::fill(normals.begin(), normals.end(), glm::vec3(0.0f));
+    return;
+  }
+  // Every grid line lies on one segment, found once.
+  float width_triangle = 1.0f / subdivisions;
+  std::vector<int> segments_v(grid_size);
+  std::vector<float> params_v(grid_size);
+  for (int j = 0; j < grid_size; j++) {
+    segments_v[j] = BezierExtraction::FindSegment(
+        surface.extraction_v, j * width_triangle, params_v[j]);
+  }
+  for (int i = 0; i < grid_size; i++) {
+    float s;
+    int eu = BezierExtraction::FindSegment(surface.extraction_u,
+                                           i * width_triangle, s);
+    for (int j = 0; j < grid_size; j++) {
+      NURBSPoint p = BezierExtraction::EvalPatch(surface, eu, segments_v[j], s,
+                                                 params_v[j]);
+      size_t k = i * grid_size + j;
+      if (!vertex_order.empty())
+        k = vertex_order[k];
+      positions[k] = p.P;
+      normals[k] = p.T;
+    }
+  }
+}
+
+void SplineTessellator::TessellateCubicPatch(
+    const std::vector<glm::mat4>& Gs,
+    SplineBasis basis,
+    int subdivisions,
+    std::vector<glm::vec3>& positions,
+    std::vector<glm::vec3>& normals) {
+  int grid_size = subdivisions + 1;
+  positions.resize(grid_size * grid_size);
+  normals.resize(grid_size * grid_size);
+  float width_triangle = 1.0f / subdivisions;
+  for (int i = 0; i < grid_size; i++) {
+    for (int j = 0; j < grid_size; j++) {
+      PatchPoint p = CubicSpline::EvalPatch(Gs, basis, i * width_triangle,
+                                            j * width_triangle);
+      positions[i * grid_size + j] = p.P;
+      normals[i * grid_size + j] = p.N;
+    }
+  }
+}
+
+std::vector<unsigned int> SplineTessellator::GetGridIndices(
+    int subdivisions) {
+  // Grid points are shared by the quads around them.
+  int grid_size = subdivisions + 1;
+  std::vector<unsigned int> indices;
+  indices.reserve(6 * subdivisions * subdivisions);
+  for (int i = 0; i < subdivisions; i++) {
+    for (int j = 0; j < subdivisions; j++) {
+      unsigned int p0 = (i + 1) * grid_size + j;
+      unsigned int p1 = (i + 1) * grid_size + j + 1;
+      unsigned int p2 = i * grid_size + j;
+      unsigned int p3 = i * grid_size + j + 1;
+      indices.insert(indices.end(), {p0, p1, p2, p2, p1, p3});
+    }
+  }
+  return indices;
+}
+}  // namespace GLOO
@@ -0,0 +1,54 @@
+#ifndef SPLINE_TESSELLATOR_H_
+#define SPLINE_TESSELLATOR_H_
+
+#include <vector>
+
+#include "BezierExtraction.hpp"
+#include "SplineTypes.hpp"
+
+namespace GLOO {
+// Samples curves into polylines and surfaces into regular grids. Output
+// arrays are resized, so scratch arrays keep their capacity between calls.
+class SplineTessellator {
+ public:
+  // num_samples points evenly spaced over the valid parameter range
+  // [knots[degree], knots[m - degree]].
+  static void SampleCurve(const NURBSCurveData& curve,
+                          int num_samples,
+                          std::vector<glm::vec3>& positions);
+  // Same samples from the extracted segments.
+  static void SampleCurve(const RationalBezierCurve& curve,
+                          int num_samples,
+                          std::vector<glm::vec3>& positions);
+  // num_samples points evenly spaced over [0, 1].
+  static void SampleCubicCurve(const glm::mat4x3& G,
+                               SplineBasis basis,
+                               int num_samples,
+                               std::vector<glm::vec3>& positions);
+  // Line segments joining num_points consecutive points.
+  static std::vector<unsigned int> GetPolylineIndices(int num_points);
+
+  // (subdivisions + 1)^2 grid points, point (i, j) at u = i / subdivisions
+  // and v = j / subdivisions going to slot i * (subdivisions + 1) + j, or to
+  // vertex_order[slot] if vertex_order is not empty.
+  static void TessellateSurface(const NURBSSurfaceData& surface,
+                                int subdivisions,
+                                const std::vector<unsigned int>& vertex_order,
+                                std::vector<glm::vec3>& positions,
+                                std::vector<glm::vec3>& normals);
+  static void TessellateSurface(const RationalBezierSurface& surface,
+                                int subdivisions,
+                                const std::vector<unsigned int>& vertex_order,
+                                std::vector<glm::vec3>& positions,
+                                std::vector<glm::vec3>& normals);
+  static void TessellateCubicPatch(const std::vector<glm::mat4>& Gs,
+                                   SplineBasis basis,
+                                   int subdivisions,
+                                   std::vector<glm::vec3>& positions,
+                                   std::vector<glm::vec3>& normals);
+  // Two triangles per cell of the grids above.
+  static std::vector<unsigned int> GetGridIndices(int subdivisions);
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef SPLINE_TYPES_H_
+#define SPLINE_TYPES_H_
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "KnotVector.hpp"
+
+namespace GLOO {
+// Basis of cubic curves and patches given by a 4x4 control matrix.
+enum class SplineBasis { Bezier, BSpline };
+
+struct CurvePoint {
+  glm::vec3 P;
+  glm::vec3 T;
+};
+
+struct PatchPoint {
+  glm::vec3 P;
+  glm::vec3 N;
+};
+
+// T is the tangent on curves and the normal on surfaces.
+struct NURBSPoint {
+  glm::vec3 P;
+  glm::vec3 T;
+};
+
+struct NURBSCurveData {
+  int degree;
+  std::vector<glm::vec3> control_points;
+  std::vector<float> weights;
+  KnotVector knots;
+};
+
+// Control points and weights are stored row by row; rows run along u.
+struct NURBSSurfaceData {
+  int num_rows;
+  int num_cols;
+  std::vector<glm::vec3> control_points;
+  std::vector<float> weights;
+  KnotVector knots_u;
+  KnotVector knots_v;
+  int degree_u;
+  int degree_v;
+
+  int GetIndex(int row, int col) const {
+    return num_cols * row + col;
+  }
+};
+
+// A weighted control point as (weight * point, weight), the form in which
+// rational curves and surfaces are summed.
+inline glm::vec4 Homogeneous(const glm::vec3& point, float weight) {
+  return glm::vec4(point * weight, weight);
+}
+}  // namespace GLOO
+
+#endif
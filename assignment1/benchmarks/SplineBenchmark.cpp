@@ -0,0 +1,333 @@
+// Times the spline evaluation kernels without a window or GL context.
+//
+// Usage: spline_benchmark [--min-time SECONDS] [--filter SUBSTRING]
+//
+// Prints one CSV row per configuration: the kernel, the degree, the number
+// of control points (per direction for surfaces), the number of samples (per
+// direction for surfaces), how many sweeps were timed and the average time
+// per evaluated sample in nanoseconds.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "spline/BezierExtraction.hpp"
+#include "spline/BSplineBasis.hpp"
+#include "spline/CubicSpline.hpp"
+#include "spline/CurveBatch.hpp"
+#include "spline/NURBSEvaluator.hpp"
+#include "spline/SplineTessellator.hpp"
+
+using namespace GLOO;
+
+namespace {
+// Results are summed here so that the kernels are not optimized away.
+volatile float g_sink;
+
+struct Options {
+  double min_time = 0.05;
+  std::string filter;
+};
+
+glm::vec3 ControlPoint(int i) {
+  return glm::vec3(std::cos(0.7f * i), std::sin(1.3f * i), 0.1f * i);
+}
+
+float Weight(int i) {
+  return 0.5f + 0.25f * (i % 3);
+}
+
+NURBSCurveData MakeCurve(int degree, int num_control_points) {
+  NURBSCurveData curve;
+  curve.degree = degree;
+  for (int i = 0; i < num_control_points; i++) {
+    curve.control_points.push_back(ControlPoint(i));
+    curve.weights.push_back(Weight(i));
+  }
+  curve.knots = KnotVector(
+      degree, BSplineBasis::UniformKnots(degree, num_control_points + degree,
+                                         true));
+  return curve;
+}
+
+NURBSSurfaceData MakeSurface(int degree, int n) {
+  NURBSSurfaceData surface;
+  surface.num_rows = n;
+  surface.num_cols = n;
+  surface.degree_u = degree;
+  surface.degree_v = degree;
+  for (int i = 0; i < n * n; i++) {
+    surface.control_points.push_back(
+        glm::vec3(i / n, i % n, std::sin(0.7f * i)));
+    surface.weights.push_back(Weight(i));
+  }
+  surface.knots_u = KnotVector(
+      degree, BSplineBasis::UniformKnots(degree, n + degree, true));
+  surface.knots_v = surface.knots_u;
+  return surface;
+}
+
+// Repeats sweep, which evaluates samples_per_sweep samples, for at least
+// min_time seconds and prints the average time per sample.
+void Run(const Options& options,
+         const std::string& kernel,
+         int degree,
+         int control_points,
+         int samples,
+         size_t samples_per_sweep,
+         const std::function<float()>& sweep) {
+  if (kernel.find(options.filter) == std::string::npos)
+    return;
+  using Clock = std::chrono::steady_clock;
+  g_sink = g_sink + sweep();  // Warm up.
+  size_t sweeps = 0;
+  Clock::time_point start = Clock::now();
+  double elapsed = 0.0;
+  while (elapsed < options.min_time) {
+    g_sink = g_sink + sweep();
+    sweeps++;
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  double ns_per_sample = elapsed * 1e9 / (sweeps * samples_per_sweep);
+  std::cout << kernel << "," << degree << "," << control_points << ","
+            << samples << "," << sweeps << "," << ns_per_sample << std::endl;
+}
+
+void BenchmarkCurves(const Options& options) {
+  for (int degree = 1; degree <= 5; degree++) {
+    for (int n : {8, 32, 128}) {
+      NURBSCurveData curve = MakeCurve(degree, n);
+      const std::vector<float>& knots = curve.knots.GetKnots();
+      RationalBezierCurve bezier;
+      BezierExtraction::ExtractCurve(curve, bezier);
+      // Once per edit; counted per extracted segment.
+      int num_segments = bezier.extraction.GetNumSegments();
+      Run(options, "BezierExtraction::ExtractCurve", degree, n, num_segments,
+          num_segments, [&]() {
+            RationalBezierCurve extracted;
+            BezierExtraction::ExtractCurve(curve, extracted);
+            return extracted.power_coefficients[0].x;
+          });
+      for (int samples : {64, 1024}) {
+        // NURBSNode::CalcNip: every basis function at every sample.
+        Run(options, "CalcNip", degree, n, samples, samples, [&]() {
+          float sum = 0.0f;
+          for (int s = 0; s < samples; s++) {
+            float t = static_cast<float>(s) / (samples - 1);
+            for (int i = 0; i < n; i++) {
+              sum += BSplineBasis::Evaluate(i, degree, t, knots);
+            }
+          }
+          return sum;
+        });
+        // Binary search against the arithmetic of a uniform KnotVector.
+        Run(options, "BSplineBasis::FindSpan", degree, n, samples, samples,
+            [&]() {
+              int sum = 0;
+              for (int s = 0; s < samples; s++) {
+                float t = static_cast<float>(s) / (samples - 1);
+                sum += BSplineBasis::FindSpan(degree, knots, t);
+              }
+              return static_cast<float>(sum);
+            });
+        Run(options, "KnotVector::FindSpan", degree, n, samples, samples,
+            [&]() {
+              int sum = 0;
+              for (int s = 0; s < samples; s++) {
+                float t = static_cast<float>(s) / (samples - 1);
+                sum += curve.knots.FindSpan(t);
+              }
+              return static_cast<float>(sum);
+            });
+        Run(options, "NURBSEvaluator::EvalCurve", degree, n, samples, samples,
+            [&]() {
+              float sum = 0.0f;
+              for (int s = 0; s < samples; s++) {
+                float t = static_cast<float>(s) / (samples - 1);
+                sum += NURBSEvaluator::EvalCurve(curve, t).P.x;
+              }
+              return sum;
+            });
+        Run(options, "BezierExtraction::EvalCurve", degree, n, samples,
+            samples, [&]() {
+              float sum = 0.0f;
+              for (int s = 0; s < samples; s++) {
+                float t = static_cast<float>(s) / (samples - 1);
+                sum += BezierExtraction::EvalCurve(bezier, t).P.x;
+              }
+              return sum;
+            });
+      }
+    }
+  }
+}
+
+void BenchmarkSurfaces(const Options& options) {
+  for (int degree : {1, 2, 3, 5}) {
+    for (int n : {4, 8, 16}) {
+      if (n <= degree)
+        continue;
+      NURBSSurfaceData surface = MakeSurface(degree, n);
+      RationalBezierSurface bezier;
+      BezierExtraction::ExtractSurface(surface, bezier);
+      for (int samples : {16, 32}) {
+        size_t num_samples = samples * samples;
+        Run(options, "NURBSSurface::EvalPatch", degree, n, samples,
+            num_samples, [&]() {
+              float sum = 0.0f;
+              for (int i = 0; i < samples; i++) {
+                for (int j = 0; j < samples; j++) {
+                  float u = static_cast<float>(i) / (samples - 1);
+                  float v = static_cast<float>(j) / (samples - 1);
+                  sum += NURBSEvaluator::EvalSurface(surface, u, v).P.x;
+                }
+              }
+              return sum;
+            });
+        Run(options, "ComputeRationalSurfaceDerivatives", degree, n, samples,
+            num_samples, [&]() {
+              float sum = 0.0f;
+              for (int i = 0; i < samples; i++) {
+                for (int j = 0; j < samples; j++) {
+                  float u = static_cast<float>(i) / (samples - 1);
+                  float v = static_cast<float>(j) / (samples - 1);
+                  sum += NURBSEvaluator::RationalSurfaceDerivatives(
+                             surface, 1, u, v)[1][0]
+                             .x;
+                }
+              }
+              return sum;
+            });
+        Run(options, "BezierExtraction::EvalSurface", degree, n, samples,
+            num_samples, [&]() {
+              float sum = 0.0f;
+              for (int i = 0; i < samples; i++) {
+                for (int j = 0; j < samples; j++) {
+                  float u = static_cast<float>(i) / (samples - 1);
+                  float v = static_cast<float>(j) / (samples - 1);
+                  sum += BezierExtraction::EvalSurface(bezier, u, v).P.x;
+                }
+              }
+              return sum;
+            });
+      }
+    }
+  }
+}
+
+// Many translated copies of one small curve, like the notes of the music
+// scene; counted per sample of every curve.
+void BenchmarkCurveBatches(const Options& options) {
+  const int kDegree = 3;
+  const int kControlPoints = 6;
+  const int kSamples = 50;
+  NURBSCurveData glyph = MakeCurve(kDegree, kControlPoints);
+  for (int num_curves : {64, 1024}) {
+    std::string suffix = " (" + std::to_string(num_curves) + " curves)";
+    std::vector<NURBSCurveData> curves(num_curves, glyph);
+    std::vector<RationalBezierCurve> beziers(num_curves);
+    std::vector<const NURBSCurveData*> curve_ptrs;
+    for (int c = 0; c < num_curves; c++) {
+      for (glm::vec3& point : curves[c].control_points) {
+        point += glm::vec3(2.0f * c, 0.5f * (c % 11), 0.0f);
+      }
+      BezierExtraction::ExtractCurve(curves[c], beziers[c]);
+      curve_ptrs.push_back(&curves[c]);
+    }
+    std::vector<std::pair<int, int>> slots;
+    std::vector<CurveBatch> batches = CurveBatch::Group(curve_ptrs, slots);
+    std::vector<glm::vec3> positions;
+    size_t num_samples = static_cast<size_t>(num_curves) * kSamples;
+    Run(options, "SplineTessellator::SampleCurve" + suffix, kDegree,
+        kControlPoints, kSamples, num_samples, [&]() {
+          float sum = 0.0f;
+          for (const RationalBezierCurve& bezier : beziers) {
+            SplineTessellator::SampleCurve(bezier, kSamples, positions);
+            sum += positions[kSamples / 2].x;
+          }
+          return sum;
+        });
+    Run(options, "CurveBatch::Sample" + suffix, kDegree, kControlPoints,
+        kSamples, num_samples, [&]() {
+          float sum = 0.0f;
+          for (const CurveBatch& batch : batches) {
+            batch.Sample(kSamples, positions);
+            sum += positions[kSamples / 2].x;
+          }
+          return sum;
+        });
+  }
+}
+
+void BenchmarkCubics(const Options& options) {
+  glm::mat4x3 G;
+  std::vector<glm::mat4> Gs(3);
+  for (int i = 0; i < 4; i++) {
+    G[i] = ControlPoint(i);
+    for (int j = 0; j < 4; j++) {
+      glm::vec3 p(i, j, std::sin(0.7f * (4 * i + j)));
+      for (int c = 0; c < 3; c++) {
+        Gs[c][j][i] = p[c];
+      }
+    }
+  }
+  for (SplineBasis basis : {SplineBasis::Bezier, SplineBasis::BSpline}) {
+    std::string suffix = basis == SplineBasis::Bezier ? "" : " (B-spline)";
+    for (int samples : {64, 1024}) {
+      Run(options, "CurveNode::EvalCurve" + suffix, 3, 4, samples, samples,
+          [&]() {
+            float sum = 0.0f;
+            for (int s = 0; s < samples; s++) {
+              float t = static_cast<float>(s) / (samples - 1);
+              sum += CubicSpline::EvalCurve(G, basis, t).P.x;
+            }
+            return sum;
+          });
+    }
+    for (int samples : {16, 64}) {
+      Run(options, "PatchNode::EvalPatch" + suffix, 3, 4, samples,
+          samples * samples, [&]() {
+            float sum = 0.0f;
+            for (int i = 0; i < samples; i++) {
+              for (int j = 0; j < samples; j++) {
+                float u = static_cast<float>(i) / (samples - 1);
+                float v = static_cast<float>(j) / (samples - 1);
+                sum += CubicSpline::EvalPatch(Gs, basis, u, v).P.x;
+              }
+            }
+            return sum;
+          });
+    }
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      options.min_time = std::atof(argv[++i]);
+    } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      options.filter = argv[++i];
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--min-time SECONDS] [--filter SUBSTRING]" << std::endl;
+      return -1;
+    }
+  }
+
+  std::cout << "kernel,degree,control_points,samples,sweeps,ns_per_sample"
+            << std::endl;
+  BenchmarkCurves(options);
+  BenchmarkSurfaces(options);
+  BenchmarkCurveBatches(options);
+  BenchmarkCubics(options);
+  return 0;
+}
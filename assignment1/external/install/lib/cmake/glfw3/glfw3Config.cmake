@@ -0,0 +1,2 @@
+add_library(glfw INTERFACE IMPORTED)
+set_target_properties(glfw PROPERTIES INTERFACE_INCLUDE_DIRECTORIES "${CMAKE_CURRENT_LIST_DIR}/../../../../src/glfw-3.3.2/include")
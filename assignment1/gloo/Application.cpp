@@ -1,13 +1,18 @@
 #include "Application.hpp"
 
 #include <iostream>
+#include <stdexcept>
 
 #include "gloo/utils.hpp"
 #include "gloo/InputManager.hpp"
+#include "gloo/Profiler.hpp"
+#include "gloo/gl_wrapper/BufferStorage.hpp"
 
 namespace GLOO {
-Application::Application(std::string app_name, glm::ivec2 window_size)
-    : app_name_(app_name), window_size_(window_size) {
+Application::Application(std::string app_name,
+                         glm::ivec2 window_size,
+                         bool headless)
+    : app_name_(app_name), window_size_(window_size), headless_(headless) {
   InitializeGLFW();
   InitializeGUI();
 
@@ -19,6 +24,10 @@ Application::~Application() {
   // Release resources before destroying everything else.
   scene_.release();
   renderer_.release();
+  // GL objects must go before the context does.
+  Profiler::GetInstance().DeleteQueries();
+  frame_recorder_.reset();
+  offscreen_framebuffer_.reset();
 
   DestroyGUI();
   glfwDestroyWindow(window_handle_);
@@ -34,6 +43,11 @@ void Application::InitializeGLFW() {
 #ifdef __APPLE__
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
+  if (headless_) {
+    // With GLOO_USE_OSMESA, GLFW creates an OSMesa context instead and no
+    // display is needed at all.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  }
 
   window_handle_ = glfwCreateWindow(window_size_.x, window_size_.y,
                                     app_name_.c_str(), nullptr, nullptr);
@@ -57,6 +71,17 @@ void Application::InitializeGLFW() {
     std::cerr << "Failed to initialize GLAD!" << std::endl;
     return;
   }
+  if (glfwExtensionSupported("GL_ARB_buffer_storage")) {
+    LoadBufferStorage(
+        (BufferStorageProc)glfwGetProcAddress("glBufferStorage"));
+  }
+
+  if (headless_) {
+    offscreen_framebuffer_ = make_unique<Framebuffer>();
+    offscreen_framebuffer_->AllocateAttachments(window_size_);
+    FramebufferSizeCallback(window_size_);
+    return;
+  }
 
   // On retina display, the initial window size will be larger
   // than requested.
@@ -92,6 +117,7 @@ void Application::UpdateGUI() {
   ImGui_ImplGlfw_NewFrame();
   ImGui::NewFrame();
   DrawGUI();
+  Profiler::GetInstance().DrawGUI();
 }
 
 void Application::RenderGUI() {
@@ -106,21 +132,71 @@ void Application::DestroyGUI() {
 }
 
 void Application::Tick(double delta_time, double current_time) {
+  Profiler& profiler = Profiler::GetInstance();
+  profiler.BeginFrame();
   // Process window events.
   glfwPollEvents();
-  UpdateGUI();
+  if (headless_) {
+    {
+      ScopedTimer timer("Scene::Update");
+      scene_->Update(delta_time);
+    }
+    BindGuard fb_bg(offscreen_framebuffer_.get());
+    renderer_->Render(*scene_);
+    if (frame_recorder_ != nullptr)
+      frame_recorder_->Capture(window_size_);
+    profiler.EndFrame();
+    return;
+  }
+  {
+    ScopedTimer timer("UpdateGUI");
+    UpdateGUI();
+  }
 
   // Logic update before rendering.
-  scene_->Update(delta_time);
+  {
+    ScopedTimer timer("Scene::Update");
+    scene_->Update(delta_time);
+  }
 
   // Rendering scene and GUI.
   renderer_->Render(*scene_);
-  RenderGUI();
+  if (frame_recorder_ != nullptr)
+    frame_recorder_->Capture(window_size_);
+  {
+    ScopedTimer timer("RenderGUI");
+    ScopedGpuTimer gpu_timer("RenderGUI");
+    RenderGUI();
+  }
 
-  glfwSwapBuffers(window_handle_);
+  {
+    // Includes waiting for vsync.
+    ScopedTimer timer("SwapBuffers");
+    glfwSwapBuffers(window_handle_);
+  }
+  profiler.EndFrame();
+}
+
+std::unique_ptr<Image> Application::CaptureFrame() const {
+  if (!headless_) {
+    throw std::runtime_error("Frames can only be captured in headless mode!");
+  }
+  return offscreen_framebuffer_->ReadColor();
+}
+
+void Application::StartRecording(const std::string& filename_prefix) {
+  frame_recorder_ = make_unique<FrameRecorder>(filename_prefix);
+}
+
+void Application::StopRecording() {
+  frame_recorder_.reset();
 }
 
 void Application::FramebufferSizeCallback(glm::ivec2 window_size) {
+  if (headless_ && window_size != offscreen_framebuffer_->GetSize()) {
+    // The hidden window never resizes the offscreen framebuffer.
+    return;
+  }
   window_size_ = window_size;
   GL_CHECK(glViewport(0, 0, window_size_.x, window_size_.y));
 }
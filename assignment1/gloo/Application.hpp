@@ -7,17 +7,38 @@
 #include "external.hpp"
 #include "Scene.hpp"
 #include "Renderer.hpp"
+#include "FrameRecorder.hpp"
+#include "Image.hpp"
+#include "gl_wrapper/Framebuffer.hpp"
 
 namespace GLOO {
 class Application {
  public:
-  Application(std::string app_name, glm::ivec2 window_size);
+  // A headless application renders into an offscreen framebuffer of
+  // window_size behind a hidden window and skips the GUI, so frames can be
+  // captured with CaptureFrame on machines without a visible desktop.
+  Application(std::string app_name,
+              glm::ivec2 window_size,
+              bool headless = false);
   virtual ~Application();
   bool IsFinished();
   void Tick(double delta_time, double current_time);
   glm::ivec2 GetWindowSize() const {
     return window_size_;
   }
+  bool IsHeadless() const {
+    return headless_;
+  }
+  // Color of the last rendered frame. Headless mode only.
+  std::unique_ptr<Image> CaptureFrame() const;
+
+  // Writes every following frame, without the GUI, to numbered PNG files
+  // until StopRecording, which waits for all of them to be written.
+  void StartRecording(const std::string& filename_prefix);
+  void StopRecording();
+  bool IsRecording() const {
+    return frame_recorder_ != nullptr;
+  }
 
   virtual void FramebufferSizeCallback(glm::ivec2 window_size);
 
@@ -38,6 +59,9 @@ class Application {
   GLFWwindow* window_handle_;
   std::string app_name_;
   glm::ivec2 window_size_;
+  bool headless_;
+  std::unique_ptr<Framebuffer> offscreen_framebuffer_;
+  std::unique_ptr<FrameRecorder> frame_recorder_;
 
   std::unique_ptr<Renderer> renderer_;
 };
@@ -0,0 +1,92 @@
+#ifndef GLOO_BOUNDING_BOX_H_
+#define GLOO_BOUNDING_BOX_H_
+
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include "alias_types.hpp"
+#include "Ray.hpp"
+
+namespace GLOO {
+// Axis-aligned bounding box. A default-constructed box is empty and grows
+// with each Expand.
+struct BoundingBox {
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+  bool IsEmpty() const {
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+  }
+
+  glm::vec3 GetCenter() const {
+    return 0.5f * (min + max);
+  }
+
+  glm::vec3 GetExtent() const {
+    return 0.5f * (max - min);
+  }
+
+  void Expand(const glm::vec3& point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+  }
+
+  void Expand(const BoundingBox& other) {
+    if (other.IsEmpty())
+      return;
+    Expand(other.min);
+    Expand(other.max);
+  }
+
+  bool Contains(const BoundingBox& other) const {
+    return glm::all(glm::lessThanEqual(min, other.min)) &&
+           glm::all(glm::greaterThanEqual(max, other.max));
+  }
+
+  float GetSurfaceArea() const {
+    glm::vec3 d = max - min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+  }
+
+  // Slab test. On a hit, t_near is the ray parameter where the ray enters the
+  // box, or 0 if its origin is inside.
+  bool Intersects(const Ray& ray, float& t_near) const {
+    glm::vec3 inv_dir = 1.0f / ray.direction;
+    glm::vec3 t0 = (min - ray.origin) * inv_dir;
+    glm::vec3 t1 = (max - ray.origin) * inv_dir;
+    glm::vec3 t_min = glm::min(t0, t1);
+    glm::vec3 t_max = glm::max(t0, t1);
+    float enter = glm::max(glm::max(t_min.x, t_min.y), glm::max(t_min.z, 0.0f));
+    float exit = glm::min(glm::min(t_max.x, t_max.y), t_max.z);
+    if (enter > exit)
+      return false;
+    t_near = enter;
+    return true;
+  }
+
+  // Smallest box enclosing this box after transformation by M.
+  BoundingBox Transformed(const glm::mat4& M) const {
+    if (IsEmpty())
+      return *this;
+    glm::vec3 center(M * glm::vec4(GetCenter(), 1.0f));
+    glm::mat3 abs_linear(glm::abs(glm::vec3(M[0])), glm::abs(glm::vec3(M[1])),
+                         glm::abs(glm::vec3(M[2])));
+    glm::vec3 extent = abs_linear * GetExtent();
+    BoundingBox result;
+    result.min = center - extent;
+    result.max = center + extent;
+    return result;
+  }
+
+  static BoundingBox FromPoints(const PositionArray& points) {
+    BoundingBox box;
+    for (const glm::vec3& p : points) {
+      box.Expand(p);
+    }
+    return box;
+  }
+};
+}  // namespace GLOO
+
+#endif
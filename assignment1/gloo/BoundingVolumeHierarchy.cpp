@@ -0,0 +1,262 @@
+#include "BoundingVolumeHierarchy.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace GLOO {
+namespace {
+// Leaf boxes are enlarged by this fraction of their diagonal.
+const float kMarginRatio = 0.1f;
+const float kMinMargin = 1e-3f;
+
+BoundingBox Union(const BoundingBox& a, const BoundingBox& b) {
+  BoundingBox result = a;
+  result.Expand(b);
+  return result;
+}
+
+BoundingBox Enlarge(const BoundingBox& box) {
+  float margin = kMarginRatio * glm::length(box.max - box.min) + kMinMargin;
+  BoundingBox result;
+  result.min = box.min - glm::vec3(margin);
+  result.max = box.max + glm::vec3(margin);
+  return result;
+}
+}  // namespace
+
+int BoundingVolumeHierarchy::Insert(const BoundingBox& box, SceneNode* node) {
+  int leaf = AllocateNode();
+  nodes_[leaf].box = Enlarge(box);
+  nodes_[leaf].tight_box = box;
+  nodes_[leaf].scene_node = node;
+  InsertLeaf(leaf);
+  leaf_count_++;
+  return leaf;
+}
+
+void BoundingVolumeHierarchy::Remove(int leaf) {
+  RemoveLeaf(leaf);
+  FreeNode(leaf);
+  leaf_count_--;
+}
+
+bool BoundingVolumeHierarchy::Update(int leaf, const BoundingBox& box) {
+  nodes_[leaf].tight_box = box;
+  if (nodes_[leaf].box.Contains(box))
+    return false;
+  RemoveLeaf(leaf);
+  nodes_[leaf].box = Enlarge(box);
+  InsertLeaf(leaf);
+  return true;
+}
+
+void BoundingVolumeHierarchy::Query(const Frustum& frustum,
+                                    std::vector<SceneNode*>& result) const {
+  if (root_ == kNullNode)
+    return;
+  std::vector<int> stack{root_};
+  while (!stack.empty()) {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    if (!frustum.Intersects(node.box))
+      continue;
+    if (node.IsLeaf()) {
+      result.push_back(node.scene_node);
+    } else {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+}
+
+SceneNode* BoundingVolumeHierarchy::RayCast(
+    const Ray& ray,
+    const std::function<bool(const SceneNode&)>& filter,
+    float* distance) const {
+  SceneNode* best = nullptr;
+  float best_t = std::numeric_limits<float>::max();
+  if (root_ == kNullNode)
+    return best;
+  std::vector<int> stack{root_};
+  while (!stack.empty()) {
+    const Node& node = nodes_[stack.back()];
+    stack.pop_back();
+    float t;
+    // Subtrees entered behind the closest hit so far cannot do better.
+    if (!node.box.Intersects(ray, t) || t >= best_t)
+      continue;
+    if (node.IsLeaf()) {
+      if (filter && !filter(*node.scene_node))
+        continue;
+      if (node.tight_box.Intersects(ray, t) && t < best_t) {
+        best_t = t;
+        best = node.scene_node;
+      }
+    } else {
+      stack.push_back(node.left);
+      stack.push_back(node.right);
+    }
+  }
+  if (best != nullptr && distance != nullptr)
+    *distance = best_t;
+  return best;
+}
+
+int BoundingVolumeHierarchy::GetHeight() const {
+  return root_ == kNullNode ? 0 : nodes_[root_].height;
+}
+
+int BoundingVolumeHierarchy::AllocateNode() {
+  int id;
+  if (free_nodes_.empty()) {
+    id = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+  } else {
+    id = free_nodes_.back();
+    free_nodes_.pop_back();
+  }
+  nodes_[id] = Node();
+  nodes_[id].height = 0;
+  return id;
+}
+
+void BoundingVolumeHierarchy::FreeNode(int id) {
+  nodes_[id] = Node();
+  free_nodes_.push_back(id);
+}
+
+void BoundingVolumeHierarchy::InsertLeaf(int leaf) {
+  if (root_ == kNullNode) {
+    root_ = leaf;
+    nodes_[leaf].parent = kNullNode;
+    return;
+  }
+
+  // Descend towards the sibling with the lowest surface area cost.
+  BoundingBox leaf_box = nodes_[leaf].box;
+  int index = root_;
+  while (!nodes_[index].IsLeaf()) {
+    const Node& node = nodes_[index];
+    float combined_area = Union(node.box, leaf_box).GetSurfaceArea();
+    // Cost of pairing the leaf with this node under a new parent.
+    float cost = 2.0f * combined_area;
+    // Cost of pushing the leaf further down, paid by every ancestor.
+    float inheritance_cost =
+        2.0f * (combined_area - node.box.GetSurfaceArea());
+
+    auto child_cost = [&](int child) {
+      const Node& c = nodes_[child];
+      float area = Union(c.box, leaf_box).GetSurfaceArea();
+      if (!c.IsLeaf())
+        area -= c.box.GetSurfaceArea();
+      return area + inheritance_cost;
+    };
+    float cost_left = child_cost(node.left);
+    float cost_right = child_cost(node.right);
+    if (cost < cost_left && cost < cost_right)
+      break;
+    index = cost_left < cost_right ? node.left : node.right;
+  }
+
+  int sibling = index;
+  int new_parent = AllocateNode();
+  int old_parent = nodes_[sibling].parent;
+  nodes_[new_parent].parent = old_parent;
+  nodes_[new_parent].box = Union(leaf_box, nodes_[sibling].box);
+  nodes_[new_parent].height = nodes_[sibling].height + 1;
+  nodes_[new_parent].left = sibling;
+  nodes_[new_parent].right = leaf;
+  nodes_[sibling].parent = new_parent;
+  nodes_[leaf].parent = new_parent;
+
+  if (old_parent == kNullNode) {
+    root_ = new_parent;
+  } else if (nodes_[old_parent].left == sibling) {
+    nodes_[old_parent].left = new_parent;
+  } else {
+    nodes_[old_parent].right = new_parent;
+  }
+  RefitAncestors(new_parent);
+}
+
+void BoundingVolumeHierarchy::RemoveLeaf(int leaf) {
+  if (leaf == root_) {
+    root_ = kNullNode;
+    return;
+  }
+
+  int parent = nodes_[leaf].parent;
+  int grand_parent = nodes_[parent].parent;
+  int sibling = nodes_[parent].left == leaf ? nodes_[parent].right
+                                            : nodes_[parent].left;
+  nodes_[sibling].parent = grand_parent;
+  if (grand_parent == kNullNode) {
+    root_ = sibling;
+  } else {
+    if (nodes_[grand_parent].left == parent)
+      nodes_[grand_parent].left = sibling;
+    else
+      nodes_[grand_parent].right = sibling;
+    RefitAncestors(grand_parent);
+  }
+  FreeNode(parent);
+}
+
+void BoundingVolumeHierarchy::RefitAncestors(int id) {
+  while (id != kNullNode) {
+    id = Balance(id);
+    Node& node = nodes_[id];
+    const Node& left = nodes_[node.left];
+    const Node& right = nodes_[node.right];
+    node.height = 1 + std::max(left.height, right.height);
+    node.box = Union(left.box, right.box);
+    id = node.parent;
+  }
+}
+
+int BoundingVolumeHierarchy::Balance(int a) {
+  Node& A = nodes_[a];
+  if (A.IsLeaf() || A.height < 2)
+    return a;
+
+  int b = A.left;
+  int c = A.right;
+  int balance = nodes_[c].height - nodes_[b].height;
+  if (balance >= -1 && balance <= 1)
+    return a;
+
+  // Rotate the taller child up; the shallower of its children moves under a.
+  bool rotate_right_up = balance > 1;
+  int up = rotate_right_up ? c : b;
+  int stay = rotate_right_up ? b : c;
+  Node& U = nodes_[up];
+  int f = U.left;
+  int g = U.right;
+
+  U.left = a;
+  U.parent = A.parent;
+  A.parent = up;
+  if (U.parent == kNullNode) {
+    root_ = up;
+  } else if (nodes_[U.parent].left == a) {
+    nodes_[U.parent].left = up;
+  } else {
+    nodes_[U.parent].right = up;
+  }
+
+  int keep = nodes_[f].height > nodes_[g].height ? f : g;
+  int give = keep == f ? g : f;
+  U.right = keep;
+  if (rotate_right_up)
+    A.right = give;
+  else
+    A.left = give;
+  nodes_[give].parent = a;
+
+  A.box = Union(nodes_[stay].box, nodes_[give].box);
+  A.height = 1 + std::max(nodes_[stay].height, nodes_[give].height);
+  U.box = Union(A.box, nodes_[keep].box);
+  U.height = 1 + std::max(A.height, nodes_[keep].height);
+  return up;
+}
+}  // namespace GLOO
@@ -0,0 +1,75 @@
+#ifndef GLOO_BOUNDING_VOLUME_HIERARCHY_H_
+#define GLOO_BOUNDING_VOLUME_HIERARCHY_H_
+
+#include <functional>
+#include <vector>
+
+#include "BoundingBox.hpp"
+#include "Frustum.hpp"
+#include "Ray.hpp"
+
+namespace GLOO {
+class SceneNode;
+
+// Dynamic AABB tree over scene nodes. Leaves store their box enlarged by a
+// margin, so small moves only need a containment check; larger moves
+// reinsert the leaf and rebalance its ancestors.
+class BoundingVolumeHierarchy {
+ public:
+  static const int kNullNode = -1;
+
+  // Returns the leaf id, which stays valid until Remove.
+  int Insert(const BoundingBox& box, SceneNode* node);
+  void Remove(int leaf);
+  // Returns true if the tree changed.
+  bool Update(int leaf, const BoundingBox& box);
+
+  // Appends nodes whose boxes intersect the frustum. Subtrees outside the
+  // frustum are skipped as a whole.
+  void Query(const Frustum& frustum, std::vector<SceneNode*>& result) const;
+
+  // Nearest node whose box is hit by the ray, or nullptr. Nodes rejected by
+  // filter are ignored.
+  SceneNode* RayCast(
+      const Ray& ray,
+      const std::function<bool(const SceneNode&)>& filter = nullptr,
+      float* distance = nullptr) const;
+
+  size_t GetLeafCount() const {
+    return leaf_count_;
+  }
+  // Height of the tree, 0 when it has at most one leaf.
+  int GetHeight() const;
+
+ private:
+  struct Node {
+    BoundingBox box;
+    // Exact bounds of a leaf, used for picking.
+    BoundingBox tight_box;
+    SceneNode* scene_node{nullptr};
+    int parent{kNullNode};
+    int left{kNullNode};
+    int right{kNullNode};
+    // Leaves have height 0; free nodes -1.
+    int height{-1};
+
+    bool IsLeaf() const {
+      return left == kNullNode;
+    }
+  };
+
+  int AllocateNode();
+  void FreeNode(int id);
+  void InsertLeaf(int leaf);
+  void RemoveLeaf(int leaf);
+  void RefitAncestors(int id);
+  int Balance(int id);
+
+  std::vector<Node> nodes_;
+  std::vector<int> free_nodes_;
+  int root_{kNullNode};
+  size_t leaf_count_{0};
+};
+}  // namespace GLOO
+
+#endif
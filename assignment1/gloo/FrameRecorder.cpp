@@ -0,0 +1,104 @@
+#include "FrameRecorder.hpp"
+
+#include <cstdio>
+
+#include "gl_wrapper/BindGuard.hpp"
+#include "utils.hpp"
+
+namespace GLOO {
+FrameRecorder::FrameRecorder(const std::string& filename_prefix)
+    : filename_prefix_(filename_prefix) {
+  for (Slot& slot : slots_) {
+    slot.buffer = make_unique<BindableBuffer>(GL_PIXEL_PACK_BUFFER);
+  }
+  encoder_ = std::thread(&FrameRecorder::EncodeLoop, this);
+}
+
+FrameRecorder::~FrameRecorder() {
+  Finish();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queue_changed_.notify_all();
+  encoder_.join();
+}
+
+void FrameRecorder::Capture(glm::ivec2 size) {
+  Slot& slot = slots_[next_slot_];
+  if (slot.fence != nullptr)
+    Retrieve(slot);
+
+  BindGuard bg(slot.buffer.get());
+  GLsizeiptr bytes = 3 * size.x * size.y;
+  if (size != slot.size) {
+    GL_CHECK(glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ));
+    slot.size = size;
+  }
+  GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+  // With a pack buffer bound this only queues the copy.
+  GL_CHECK(glReadPixels(0, 0, size.x, size.y, GL_RGB, GL_UNSIGNED_BYTE,
+                        nullptr));
+  slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  GL_CHECK_ERROR();
+  slot.frame = frame_count_++;
+  next_slot_ = (next_slot_ + 1) % kRingSize;
+}
+
+void FrameRecorder::Finish() {
+  // Oldest first, so frames reach the encoder in order.
+  for (int i = 0; i < kRingSize; i++) {
+    Slot& slot = slots_[(next_slot_ + i) % kRingSize];
+    if (slot.fence != nullptr)
+      Retrieve(slot);
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_changed_.wait(lock, [this] { return queue_.empty(); });
+}
+
+void FrameRecorder::Retrieve(Slot& slot) {
+  GL_CHECK(glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                            GL_TIMEOUT_IGNORED));
+  GL_CHECK(glDeleteSync(slot.fence));
+  slot.fence = nullptr;
+
+  std::unique_ptr<Image> image;
+  {
+    BindGuard bg(slot.buffer.get());
+    GLsizeiptr bytes = 3 * slot.size.x * slot.size.y;
+    auto data = static_cast<const uint8_t*>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT));
+    GL_CHECK_ERROR();
+    image = Image::FromByteData(slot.size.x, slot.size.y, data);
+    GL_CHECK(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_changed_.wait(lock,
+                      [this] { return queue_.size() < kMaxQueuedFrames; });
+  queue_.emplace_back(std::move(image), slot.frame);
+  lock.unlock();
+  queue_changed_.notify_all();
+}
+
+void FrameRecorder::EncodeLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queue_changed_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty())
+      return;
+
+    // Keep the frame queued while encoding so Finish waits for it.
+    Image& image = *queue_.front().first;
+    size_t frame = queue_.front().second;
+    lock.unlock();
+    char number[16];
+    std::snprintf(number, sizeof(number), "%05zu", frame);
+    image.SavePNG(filename_prefix_ + number + ".png");
+    lock.lock();
+
+    queue_.pop_front();
+    queue_changed_.notify_all();
+  }
+}
+}  // namespace GLOO
@@ -0,0 +1,70 @@
+#ifndef GLOO_FRAME_RECORDER_H_
+#define GLOO_FRAME_RECORDER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Image.hpp"
+#include "gl_wrapper/BindableBuffer.hpp"
+
+namespace GLOO {
+// Writes rendered frames to numbered PNG files without stalling the GPU.
+// Each Capture starts an asynchronous glReadPixels into one of a ring of
+// pixel buffer objects. A frame is mapped kRingSize captures later, when its
+// fence has long signaled, and a background thread encodes it.
+class FrameRecorder {
+ public:
+  // Frames are written to filename_prefix + "00000.png" and up.
+  FrameRecorder(const std::string& filename_prefix);
+  ~FrameRecorder();
+
+  FrameRecorder(const FrameRecorder&) = delete;
+  FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+  // Reads the color buffer of the bound read framebuffer. Call before
+  // swapping buffers when recording the default framebuffer.
+  void Capture(glm::ivec2 size);
+  // Blocks until every captured frame has been written.
+  void Finish();
+
+  size_t GetFrameCount() const {
+    return frame_count_;
+  }
+
+ private:
+  static const int kRingSize = 3;
+  // Captures block while this many frames wait for the encoder.
+  static const size_t kMaxQueuedFrames = 8;
+
+  struct Slot {
+    std::unique_ptr<BindableBuffer> buffer;
+    GLsync fence{nullptr};
+    glm::ivec2 size{0};
+    size_t frame{0};
+  };
+
+  void Retrieve(Slot& slot);
+  void EncodeLoop();
+
+  std::string filename_prefix_;
+  Slot slots_[kRingSize];
+  int next_slot_{0};
+  size_t frame_count_{0};
+
+  std::deque<std::pair<std::unique_ptr<Image>, size_t>> queue_;
+  std::mutex mutex_;
+  std::condition_variable queue_changed_;
+  bool stopping_{false};
+  std::thread encoder_;
+};
+}  // namespace GLOO
+
+#endif
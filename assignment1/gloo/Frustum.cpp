@@ -0,0 +1,29 @@
+#include "Frustum.hpp"
+
+namespace GLOO {
+Frustum::Frustum(const glm::mat4& view_projection) {
+  // Gribb & Hartmann: each plane is the fourth row of the matrix plus or
+  // minus one of the other rows. glm matrices are column-major.
+  glm::mat4 T = glm::transpose(view_projection);
+  for (int i = 0; i < 3; i++) {
+    planes_[2 * i] = T[3] + T[i];
+    planes_[2 * i + 1] = T[3] - T[i];
+  }
+  for (glm::vec4& plane : planes_) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+}
+
+bool Frustum::Intersects(const BoundingBox& box) const {
+  glm::vec3 center = box.GetCenter();
+  glm::vec3 extent = box.GetExtent();
+  for (const glm::vec4& plane : planes_) {
+    glm::vec3 normal(plane);
+    // Signed distance of the box corner furthest along the plane normal.
+    float reach = glm::dot(extent, glm::abs(normal));
+    if (glm::dot(normal, center) + plane.w + reach < 0.0f)
+      return false;
+  }
+  return true;
+}
+}  // namespace GLOO
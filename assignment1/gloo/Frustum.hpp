@@ -0,0 +1,24 @@
+#ifndef GLOO_FRUSTUM_H_
+#define GLOO_FRUSTUM_H_
+
+#include <glm/glm.hpp>
+
+#include "BoundingBox.hpp"
+
+namespace GLOO {
+// View frustum as six inward-facing planes (left, right, bottom, top, near,
+// far), extracted from a view-projection matrix.
+class Frustum {
+ public:
+  Frustum(const glm::mat4& view_projection);
+
+  // Conservative: may report boxes just outside a frustum corner as visible,
+  // never the other way around.
+  bool Intersects(const BoundingBox& box) const;
+
+ private:
+  glm::vec4 planes_[6];
+};
+}  // namespace GLOO
+
+#endif
@@ -1,6 +1,13 @@
 #include "Image.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
+#include <thread>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -10,52 +17,167 @@
 #include "gloo/utils.hpp"
 
 namespace {
+using GLOO::ImageLayout;
+
+// Images with fewer pixels are converted on the calling thread.
+const size_t kMinParallelPixels = 1 << 18;
+
+// Calls f(row_begin, row_end) on contiguous row ranges covering
+// [0, num_rows), spread over the hardware threads for large images.
+template <class F>
+void ParallelForRows(size_t num_rows, size_t row_pixels, const F& f) {
+  size_t num_threads = std::thread::hardware_concurrency();
+  if (num_threads <= 1 || num_rows * row_pixels < kMinParallelPixels) {
+    f(0, num_rows);
+    return;
+  }
+  num_threads = std::min(num_threads, num_rows);
+  size_t chunk = (num_rows + num_threads - 1) / num_threads;
+  std::vector<std::thread> threads;
+  for (size_t begin = chunk; begin < num_rows; begin += chunk) {
+    threads.emplace_back(f, begin, std::min(begin + chunk, num_rows));
+  }
+  f(0, std::min(chunk, num_rows));
+  for (std::thread& t : threads) {
+    t.join();
+  }
+}
+
 static uint8_t ClampColor(float c) {
-  int tmp = int(c * 255);
-  if (tmp < 0)
-    tmp = 0;
+  float tmp = c * 255;
+  // Also maps NaN to 0.
+  if (!(tmp > 0))
+    return 0;
   if (tmp > 255)
     tmp = 255;
 
   return static_cast<uint8_t>(tmp);
 }
+
+// ClampColor over n floats.
+void FloatsToBytes(const float* src, uint8_t* dst, size_t n) {
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128 scale = _mm_set1_ps(255.0f);
+  const __m128 zero = _mm_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    __m128i v[4];
+    for (int k = 0; k < 4; k++) {
+      __m128 f = _mm_mul_ps(_mm_loadu_ps(src + i + 4 * k), scale);
+      // max returns its second operand for NaN.
+      f = _mm_min_ps(_mm_max_ps(f, zero), scale);
+      v[k] = _mm_cvttps_epi32(f);
+    }
+    __m128i lo = _mm_packs_epi32(v[0], v[1]);
+    __m128i hi = _mm_packs_epi32(v[2], v[3]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+#endif
+  for (; i < n; i++) {
+    dst[i] = ClampColor(src[i]);
+  }
+}
+
+// Simple enough for the compiler to vectorize.
+void BytesToFloats(const uint8_t* src, float* dst, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]) / 255.0f;
+  }
+}
+
+// Interleaves one row of each of the three planes.
+template <class T>
+void InterleaveRow(const T* r, const T* g, const T* b, T* dst, size_t n) {
+  for (size_t x = 0; x < n; x++, dst += 3) {
+    dst[0] = r[x];
+    dst[1] = g[x];
+    dst[2] = b[x];
+  }
+}
 }  // namespace
 
 namespace GLOO {
 std::vector<uint8_t> Image::ToByteData() const {
-  std::vector<uint8_t> buffer;
-
-  for (int y = (int)height_ - 1; y >= 0; y--)
-    for (size_t x = 0; x < width_; x++) {
-      const glm::vec3& color = GetPixel(x, static_cast<size_t>(y));
-      buffer.push_back(ClampColor(color[0]));
-      buffer.push_back(ClampColor(color[1]));
-      buffer.push_back(ClampColor(color[2]));
+  std::vector<uint8_t> buffer(data_.size());
+  size_t plane_size = width_ * height_;
+  ParallelForRows(height_, width_, [&](size_t begin, size_t end) {
+    std::vector<uint8_t> planar_row;
+    if (layout_ == ImageLayout::Planar)
+      planar_row.resize(3 * width_);
+    for (size_t row = begin; row < end; row++) {
+      // PNG rows start at the top.
+      size_t y = height_ - 1 - row;
+      uint8_t* dst = &buffer[3 * width_ * row];
+      if (layout_ == ImageLayout::Interleaved) {
+        FloatsToBytes(&data_[3 * width_ * y], dst, 3 * width_);
+      } else {
+        for (int c = 0; c < 3; c++) {
+          FloatsToBytes(&data_[c * plane_size + y * width_],
+                        &planar_row[c * width_], width_);
+        }
+        InterleaveRow(&planar_row[0], &planar_row[width_],
+                      &planar_row[2 * width_], dst, width_);
+      }
     }
-
+  });
   return buffer;
 }
 
 std::vector<float> Image::ToFloatData() const {
-  std::vector<float> buffer;
-
-  for (int y = (int)height_ - 1; y >= 0; y--)
-    for (size_t x = 0; x < width_; x++) {
-      const glm::vec3& color = GetPixel(x, static_cast<size_t>(y));
-      buffer.push_back(color[0]);
-      buffer.push_back(color[1]);
-      buffer.push_back(color[2]);
+  std::vector<float> buffer(data_.size());
+  size_t plane_size = width_ * height_;
+  ParallelForRows(height_, width_, [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; row++) {
+      size_t y = height_ - 1 - row;
+      float* dst = &buffer[3 * width_ * row];
+      if (layout_ == ImageLayout::Interleaved) {
+        std::memcpy(dst, &data_[3 * width_ * y], 3 * width_ * sizeof(float));
+      } else {
+        const float* src = &data_[y * width_];
+        InterleaveRow(src, src + plane_size, src + 2 * plane_size, dst,
+                      width_);
+      }
     }
-
+  });
   return buffer;
 }
 
+void Image::ConvertLayout(ImageLayout layout) {
+  if (layout == layout_)
+    return;
+  std::vector<float> converted(data_.size());
+  size_t plane_size = width_ * height_;
+  for (size_t p = 0; p < plane_size; p++) {
+    for (size_t c = 0; c < 3; c++) {
+      if (layout == ImageLayout::Planar)
+        converted[c * plane_size + p] = data_[3 * p + c];
+      else
+        converted[3 * p + c] = data_[c * plane_size + p];
+    }
+  }
+  data_.swap(converted);
+  layout_ = layout;
+}
+
 void Image::SavePNG(const std::string& filename) const {
   auto buffer = ToByteData();
   stbi_write_png(filename.c_str(), (int)width_, (int)height_, 3, buffer.data(),
                  (int)width_ * 3);
 }
 
+std::unique_ptr<Image> Image::FromByteData(size_t width,
+                                           size_t height,
+                                           const uint8_t* data) {
+  auto image = make_unique<Image>(width, height);
+  float* dst = image->data_.data();
+  ParallelForRows(height, width, [&](size_t begin, size_t end) {
+    size_t offset = 3 * width * begin;
+    BytesToFloats(data + offset, dst + offset, 3 * width * (end - begin));
+  });
+  return image;
+}
+
 std::unique_ptr<Image> Image::LoadPNG(const std::string& filename,
                                       bool y_reversed) {
   int w, h, n;
@@ -64,20 +186,19 @@ std::unique_ptr<Image> Image::LoadPNG(const std::string& filename,
     throw std::runtime_error("Cannot load " + filename + "!");
   }
   if (n != 3) {
+    stbi_image_free(buffer);
     throw std::runtime_error("Wrong number of channels in " + filename + "!");
   }
   auto image = make_unique<Image>(w, h);
 
-  int dy = y_reversed ? -1 : 1;
-  int y_start = y_reversed ? h - 1 : 0;
-  int y_end = y_reversed ? -1 : h;
-  for (int c = 0, p = 0, y = y_start; y != y_end; y += dy) {
-    for (int x = 0; x < w; x++, p++) {
-      glm::vec3& pixel = image->data_[p];
-      for (int t = 0; t < 3; t++)
-        pixel[t] = static_cast<float>(buffer[c++]) / 255.0f;
+  size_t row_size = 3 * static_cast<size_t>(w);
+  float* dst = image->data_.data();
+  ParallelForRows(h, w, [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; row++) {
+      size_t y = y_reversed ? h - 1 - row : row;
+      BytesToFloats(buffer + row_size * row, dst + row_size * y, row_size);
     }
-  }
+  });
   stbi_image_free(buffer);
   return image;
 }
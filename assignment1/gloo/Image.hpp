@@ -10,12 +10,21 @@
 #include <glm/glm.hpp>
 
 namespace GLOO {
+// How the RGB floats of an Image are stored:
+//   Interleaved: RGBRGB... per pixel, as in the byte data of PNG files.
+//   Planar:      all R, then all G, then all B; suits per-channel kernels.
+enum class ImageLayout { Interleaved, Planar };
+
+// Row 0 of an Image is the bottom row unless loaded otherwise.
 class Image {
  public:
-  Image(size_t width, size_t height) {
+  Image(size_t width,
+        size_t height,
+        ImageLayout layout = ImageLayout::Interleaved) {
     width_ = width;
     height_ = height;
-    data_.resize(width_ * height_);
+    layout_ = layout;
+    data_.resize(3 * width_ * height_);
   }
 
   size_t GetWidth() const {
@@ -26,33 +35,61 @@ class Image {
     return height_;
   }
 
+  ImageLayout GetLayout() const {
+    return layout_;
+  }
+
   void SetPixel(size_t x, size_t y, const glm::vec3& color) {
     if (x < width_ && y < height_) {
-      data_[y * width_ + x] = color;
+      for (int c = 0; c < 3; c++)
+        data_[GetIndex(x, y, c)] = color[c];
     } else {
       throw std::runtime_error("Unable to set a pixel outside of image range.");
     }
   }
 
-  const glm::vec3& GetPixel(size_t x, size_t y) const {
+  glm::vec3 GetPixel(size_t x, size_t y) const {
     if (x < width_ && y < height_) {
-      return data_[y * width_ + x];
+      return glm::vec3(data_[GetIndex(x, y, 0)], data_[GetIndex(x, y, 1)],
+                       data_[GetIndex(x, y, 2)]);
     } else {
       std::cout << "(" << x << "," << y << ")" << std::endl;
       throw std::runtime_error("Unable to get a pixel outside of image range.");
     }
   }
 
+  // Raw floats in the order given by the layout.
+  const float* GetData() const {
+    return data_.data();
+  }
+  float* GetData() {
+    return data_.data();
+  }
+  void ConvertLayout(ImageLayout layout);
+
   static std::unique_ptr<Image> LoadPNG(const std::string& filename,
                                         bool y_reversed);
+  // Converts tightly packed 8-bit RGB rows, bottom row first as returned by
+  // glReadPixels.
+  static std::unique_ptr<Image> FromByteData(size_t width,
+                                             size_t height,
+                                             const uint8_t* data);
   void SavePNG(const std::string& filename) const;
+  // Interleaved RGB, top row first.
   std::vector<uint8_t> ToByteData() const;
   std::vector<float> ToFloatData() const;
 
  private:
-  std::vector<glm::vec3> data_;
+  size_t GetIndex(size_t x, size_t y, int c) const {
+    size_t p = y * width_ + x;
+    return layout_ == ImageLayout::Interleaved ? 3 * p + c
+                                               : c * width_ * height_ + p;
+  }
+
+  std::vector<float> data_;
   size_t width_;
   size_t height_;
+  ImageLayout layout_;
 };
 }  // namespace GLOO
 
@@ -4,6 +4,7 @@
 #include <cassert>
 
 #include "external.hpp"
+#include "components/CameraComponent.hpp"
 
 namespace GLOO {
 void InputManager::SetWindow(GLFWwindow* window) {
@@ -30,6 +31,24 @@ glm::dvec2 InputManager::GetCursorPosition() {
   return glm::dvec2(xpos, ypos);
 }
 
+Ray InputManager::GetCursorRay(const CameraComponent& camera) {
+  // Cursor positions are in screen coordinates, which differ from the
+  // framebuffer size on high-DPI displays.
+  int width, height;
+  glfwGetWindowSize(window_, &width, &height);
+  glm::dvec2 cursor = GetCursorPosition();
+  glm::vec2 ndc(2.0 * cursor.x / width - 1.0, 1.0 - 2.0 * cursor.y / height);
+
+  glm::mat4 inv_view_proj =
+      glm::inverse(camera.GetProjectionMatrix() * camera.GetViewMatrix());
+  glm::vec4 near_point = inv_view_proj * glm::vec4(ndc, -1.0f, 1.0f);
+  glm::vec4 far_point = inv_view_proj * glm::vec4(ndc, 1.0f, 1.0f);
+  Ray ray;
+  ray.origin = glm::vec3(near_point) / near_point.w;
+  ray.direction = glm::vec3(far_point) / far_point.w - ray.origin;
+  return ray;
+}
+
 bool InputManager::IsLeftMousePressed() {
   if (ImGui::GetIO().WantCaptureMouse)
     return false;
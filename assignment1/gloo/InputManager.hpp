@@ -4,8 +4,11 @@
 #include <functional>
 
 #include "external.hpp"
+#include "Ray.hpp"
 
 namespace GLOO {
+class CameraComponent;
+
 class InputManager {
  public:
   // Singleton design pattern.
@@ -28,6 +31,9 @@ class InputManager {
   bool IsKeyReleased(int key);
 
   glm::dvec2 GetCursorPosition();
+  // World-space ray from the camera through the cursor, for picking with
+  // Scene::Pick.
+  Ray GetCursorRay(const CameraComponent& camera);
 
   bool IsLeftMousePressed();
   bool IsRightMousePressed();
@@ -0,0 +1,56 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace GLOO {
+MappedFile::MappedFile(const std::string& file_path) {
+#ifndef _WIN32
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  struct stat st;
+  if (fstat(fd, &st) == 0) {
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+      is_open_ = true;
+    } else {
+      void* ptr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (ptr != MAP_FAILED) {
+        // Parsers read front to back.
+        madvise(ptr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(ptr);
+        is_mapped_ = true;
+        is_open_ = true;
+      }
+    }
+  }
+  close(fd);
+  if (is_open_)
+    return;
+#endif
+  std::ifstream ifs(file_path, std::ios::binary | std::ios::ate);
+  if (!ifs)
+    return;
+  size_ = static_cast<size_t>(ifs.tellg());
+  buffer_.resize(size_);
+  ifs.seekg(0);
+  if (!ifs.read(buffer_.data(), size_))
+    return;
+  data_ = buffer_.data();
+  is_open_ = true;
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (is_mapped_)
+    munmap(const_cast<char*>(data_), size_);
+#endif
+}
+}  // namespace GLOO
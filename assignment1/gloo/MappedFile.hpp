@@ -0,0 +1,38 @@
+#ifndef GLOO_MAPPED_FILE_H_
+#define GLOO_MAPPED_FILE_H_
+
+#include <string>
+#include <vector>
+
+namespace GLOO {
+// Read-only view of a whole file. The file is memory-mapped where the
+// platform supports it and read into memory otherwise.
+class MappedFile {
+ public:
+  MappedFile(const std::string& file_path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool IsOpen() const {
+    return is_open_;
+  }
+  const char* GetData() const {
+    return data_;
+  }
+  size_t GetSize() const {
+    return size_;
+  }
+
+ private:
+  bool is_open_{false};
+  const char* data_{nullptr};
+  size_t size_{0};
+  bool is_mapped_{false};
+  // Used when the file could not be mapped.
+  std::vector<char> buffer_;
+};
+}  // namespace GLOO
+
+#endif
@@ -0,0 +1,246 @@
+#include "MeshCache.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include <sys/stat.h>
+
+#include "MappedFile.hpp"
+#include "utils.hpp"
+
+namespace {
+using namespace GLOO;
+
+const char kMagic[8] = {'G', 'L', 'O', 'O', 'M', 'E', 'S', 'H'};
+// Bump whenever the layout below or the stored vertex order changes.
+const uint32_t kVersion = 3;
+
+// Followed by the position, normal, texture coordinate and index arrays,
+// then each group as start, count, name and material name, then the
+// material library. Strings are a 32-bit length and the characters.
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_groups;
+  uint64_t source_size;
+  int64_t source_mtime;
+  uint64_t source_hash;
+  uint64_t num_positions;
+  uint64_t num_normals;
+  uint64_t num_tex_coords;
+  uint64_t num_indices;
+  float acmr_before;
+  float acmr_after;
+};
+
+bool GetFileStamp(const std::string& file_path,
+                  uint64_t& size,
+                  int64_t& mtime) {
+  struct stat st;
+  if (stat(file_path.c_str(), &st) != 0)
+    return false;
+  size = static_cast<uint64_t>(st.st_size);
+  mtime = static_cast<int64_t>(st.st_mtime);
+  return true;
+}
+
+// 64-bit FNV-1a of the file contents, or 0 if it cannot be read.
+uint64_t HashFile(const std::string& file_path) {
+  MappedFile file(file_path);
+  if (!file.IsOpen())
+    return 0;
+  uint64_t hash = 14695981039346656037ull;
+  const unsigned char* data =
+      reinterpret_cast<const unsigned char*>(file.GetData());
+  for (size_t i = 0; i < file.GetSize(); i++) {
+    hash = (hash ^ data[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+template <class T>
+size_t GetCount(const std::unique_ptr<std::vector<T>>& array) {
+  return array == nullptr ? 0 : array->size();
+}
+
+class CacheReader {
+ public:
+  CacheReader(const char* data, size_t size)
+      : cur_(data), end_(data + size) {
+  }
+
+  bool Read(void* dst, size_t bytes) {
+    if (static_cast<size_t>(end_ - cur_) < bytes)
+      return false;
+    std::memcpy(dst, cur_, bytes);
+    cur_ += bytes;
+    return true;
+  }
+
+  template <class T>
+  bool ReadArray(uint64_t count, std::unique_ptr<std::vector<T>>& array) {
+    if (count == 0)
+      return true;
+    if (count > static_cast<size_t>(end_ - cur_) / sizeof(T))
+      return false;
+    array = make_unique<std::vector<T>>(count);
+    return Read(array->data(), count * sizeof(T));
+  }
+
+  bool ReadString(std::string& str) {
+    uint32_t length;
+    if (!Read(&length, sizeof(length)) ||
+        static_cast<size_t>(end_ - cur_) < length)
+      return false;
+    str.assign(cur_, length);
+    cur_ += length;
+    return true;
+  }
+
+ private:
+  const char* cur_;
+  const char* end_;
+};
+
+void Write(std::ofstream& ofs, const void* src, size_t bytes) {
+  ofs.write(static_cast<const char*>(src), bytes);
+}
+
+template <class T>
+void WriteArray(std::ofstream& ofs,
+                const std::unique_ptr<std::vector<T>>& array) {
+  if (array != nullptr)
+    Write(ofs, array->data(), array->size() * sizeof(T));
+}
+
+void WriteString(std::ofstream& ofs, const std::string& str) {
+  uint32_t length = static_cast<uint32_t>(str.size());
+  Write(ofs, &length, sizeof(length));
+  Write(ofs, str.data(), str.size());
+}
+}  // namespace
+
+namespace GLOO {
+bool MeshCache::Load(const std::string& obj_file_path,
+                     ObjParser::ParsedData& data,
+                     MeshOptimizer::Stats& acmr) {
+  uint64_t source_size;
+  int64_t source_mtime;
+  if (!GetFileStamp(obj_file_path, source_size, source_mtime))
+    return false;
+  MappedFile file(GetCachePath(obj_file_path));
+  if (!file.IsOpen())
+    return false;
+
+  CacheReader reader(file.GetData(), file.GetSize());
+  CacheHeader header;
+  if (!reader.Read(&header, sizeof(header)) ||
+      std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion || header.source_size != source_size)
+    return false;
+  // A touched but unchanged file still hashes the same.
+  bool stale = header.source_mtime != source_mtime;
+  if (stale && HashFile(obj_file_path) != header.source_hash)
+    return false;
+
+  ObjParser::ParsedData cached;
+  if (!reader.ReadArray(header.num_positions, cached.positions) ||
+      !reader.ReadArray(header.num_normals, cached.normals) ||
+      !reader.ReadArray(header.num_tex_coords, cached.tex_coords) ||
+      !reader.ReadArray(header.num_indices, cached.indices))
+    return false;
+  for (uint32_t i = 0; i < header.num_groups; i++) {
+    uint64_t range[2];
+    MeshGroup group;
+    if (!reader.Read(range, sizeof(range)) || !reader.ReadString(group.name) ||
+        !reader.ReadString(group.material_name))
+      return false;
+    group.start_face_index = static_cast<size_t>(range[0]);
+    group.num_indices = static_cast<size_t>(range[1]);
+    cached.groups.push_back(std::move(group));
+  }
+  if (!reader.ReadString(cached.material_lib))
+    return false;
+  if (cached.indices != nullptr) {
+    for (unsigned int idx : *cached.indices) {
+      if (idx >= header.num_positions)
+        return false;
+    }
+  }
+  for (const MeshGroup& group : cached.groups) {
+    if (group.start_face_index > header.num_indices ||
+        group.num_indices > header.num_indices - group.start_face_index)
+      return false;
+  }
+
+  if (!cached.material_lib.empty()) {
+    ObjParser::AssociateMaterials(
+        GetBasePath(obj_file_path) + cached.material_lib, cached.groups);
+  }
+  data = std::move(cached);
+  acmr = {header.acmr_before, header.acmr_after};
+  // Record the new time so later loads can skip hashing.
+  if (stale)
+    Save(obj_file_path, data, acmr);
+  return true;
+}
+
+void MeshCache::Save(const std::string& obj_file_path,
+                     const ObjParser::ParsedData& data,
+                     const MeshOptimizer::Stats& acmr) {
+  CacheHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_groups = static_cast<uint32_t>(data.groups.size());
+  if (!GetFileStamp(obj_file_path, header.source_size, header.source_mtime))
+    return;
+  header.source_hash = HashFile(obj_file_path);
+  header.num_positions = GetCount(data.positions);
+  header.num_normals = GetCount(data.normals);
+  header.num_tex_coords = GetCount(data.tex_coords);
+  header.num_indices = GetCount(data.indices);
+  header.acmr_before = acmr.acmr_before;
+  header.acmr_after = acmr.acmr_after;
+
+  // Written aside and renamed, so a reader never sees a partial cache.
+  std::string cache_path = GetCachePath(obj_file_path);
+  std::string temp_path = cache_path + ".tmp";
+  {
+    std::ofstream ofs(temp_path, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      std::cerr << "WARNING: Unable to write mesh cache " << cache_path << "!"
+                << std::endl;
+      return;
+    }
+    Write(ofs, &header, sizeof(header));
+    WriteArray(ofs, data.positions);
+    WriteArray(ofs, data.normals);
+    WriteArray(ofs, data.tex_coords);
+    WriteArray(ofs, data.indices);
+    for (const MeshGroup& group : data.groups) {
+      uint64_t range[2] = {group.start_face_index, group.num_indices};
+      Write(ofs, range, sizeof(range));
+      WriteString(ofs, group.name);
+      WriteString(ofs, group.material_name);
+    }
+    WriteString(ofs, data.material_lib);
+    if (!ofs) {
+      ofs.close();
+      std::remove(temp_path.c_str());
+      return;
+    }
+  }
+  // Windows does not rename over an existing file.
+  std::remove(cache_path.c_str());
+  if (std::rename(temp_path.c_str(), cache_path.c_str()) != 0)
+    std::remove(temp_path.c_str());
+}
+
+std::string MeshCache::GetCachePath(const std::string& obj_file_path) {
+  return obj_file_path + ".meshcache";
+}
+}  // namespace GLOO
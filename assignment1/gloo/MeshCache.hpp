@@ -0,0 +1,30 @@
+#ifndef GLOO_MESH_CACHE_H_
+#define GLOO_MESH_CACHE_H_
+
+#include <string>
+
+#include "MeshOptimizer.hpp"
+#include "parsers/ObjParser.hpp"
+
+namespace GLOO {
+// Binary copy of a parsed OBJ file, kept next to it as <file>.meshcache.
+// A cache is current when the size and modification time of the OBJ match
+// the ones it was written for, or failing that, when the contents hash the
+// same.
+class MeshCache {
+ public:
+  // Returns false, leaving data and acmr untouched, when there is no
+  // current cache. acmr is what the import's optimization measured.
+  static bool Load(const std::string& obj_file_path,
+                   ObjParser::ParsedData& data,
+                   MeshOptimizer::Stats& acmr);
+  // Failing to write the cache only costs the next load a parse.
+  static void Save(const std::string& obj_file_path,
+                   const ObjParser::ParsedData& data,
+                   const MeshOptimizer::Stats& acmr);
+
+  static std::string GetCachePath(const std::string& obj_file_path);
+};
+}  // namespace GLOO
+
+#endif
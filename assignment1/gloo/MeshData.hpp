@@ -3,6 +3,7 @@
 
 #include "gloo/VertexObject.hpp"
 #include "gloo/Material.hpp"
+#include "gloo/MeshOptimizer.hpp"
 
 namespace GLOO {
 struct MeshGroup {
@@ -16,6 +17,8 @@ struct MeshGroup {
 struct MeshData {
   std::unique_ptr<VertexObject> vertex_obj;
   std::vector<MeshGroup> groups;
+  // ACMR of the indices before and after the import reordered them.
+  MeshOptimizer::Stats acmr{0.0f, 0.0f};
 };
 }  // namespace GLOO
 
@@ -4,24 +4,93 @@
 #include <algorithm>
 
 #include "gloo/utils.hpp"
+#include "MeshCache.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
 
-namespace GLOO {
-MeshData MeshLoader::Import(const std::string& filename) {
+namespace {
+using namespace GLOO;
+
+// Whether every attribute has one entry per position, so that vertices can
+// be renumbered. Only files whose faces index positions alone may differ.
+bool HasAlignedAttributes(const ObjParser::ParsedData& data) {
+  size_t num_vertices = data.positions->size();
+  return (data.normals == nullptr || data.normals->size() == num_vertices) &&
+         (data.tex_coords == nullptr ||
+          data.tex_coords->size() == num_vertices);
+}
+
+// Index ranges drawn separately: one per group, plus any faces before the
+// first group.
+std::vector<size_t> GetRangeBounds(const ObjParser::ParsedData& data) {
+  std::vector<size_t> bounds{0, data.indices->size()};
+  for (const MeshGroup& g : data.groups) {
+    bounds.push_back(g.start_face_index);
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+  return bounds;
+}
+
+// Reorders triangles within each group, then vertices across the mesh.
+MeshOptimizer::Stats OptimizeMesh(ObjParser::ParsedData& data) {
+  if (data.indices == nullptr || data.positions == nullptr)
+    return {0.0f, 0.0f};
+  IndexArray& indices = *data.indices;
+  size_t num_vertices = data.positions->size();
+  float acmr_before = MeshOptimizer::ComputeACMR(indices, num_vertices);
+  std::vector<size_t> bounds = GetRangeBounds(data);
+  for (size_t i = 0; i + 1 < bounds.size(); i++) {
+    MeshOptimizer::OptimizeVertexCache(indices, num_vertices, bounds[i],
+                                       bounds[i + 1] - bounds[i]);
+  }
+
+  if (HasAlignedAttributes(data)) {
+    std::vector<unsigned int> remap =
+        MeshOptimizer::OptimizeVertexFetch(indices, num_vertices);
+    MeshOptimizer::RemapVertices(remap, *data.positions);
+    if (data.normals != nullptr)
+      MeshOptimizer::RemapVertices(remap, *data.normals);
+    if (data.tex_coords != nullptr)
+      MeshOptimizer::RemapVertices(remap, *data.tex_coords);
+  }
+  return {acmr_before, MeshOptimizer::ComputeACMR(indices, num_vertices)};
+}
+
+bool LoadParsedData(const std::string& filename,
+                    ObjParser::ParsedData& data,
+                    MeshOptimizer::Stats& acmr) {
   std::string file_path = GetAssetDir() + filename;
-  bool success;
-  auto parsed_data = ObjParser::Parse(file_path, success);
-  if (!success) {
-    std::cerr << "Load mesh file " << filename << " failed!" << std::endl;
-    return {};
+  if (!MeshCache::Load(file_path, data, acmr)) {
+    bool success;
+    data = ObjParser::Parse(file_path, success);
+    if (!success) {
+      std::cerr << "Load mesh file " << filename << " failed!" << std::endl;
+      return false;
+    }
+    // The cache keeps the optimized order.
+    acmr = OptimizeMesh(data);
+    MeshCache::Save(file_path, data, acmr);
   }
   // Remove empty groups.
-  parsed_data.groups.erase(
-      std::remove_if(parsed_data.groups.begin(), parsed_data.groups.end(),
+  data.groups.erase(
+      std::remove_if(data.groups.begin(), data.groups.end(),
                      [](MeshGroup& g) { return g.num_indices == 0; }),
-      parsed_data.groups.end());
+      data.groups.end());
+  return true;
+}
 
+MeshData CreateMeshData(ObjParser::ParsedData parsed_data,
+                        VertexFormat format,
+                        const MeshOptimizer::Stats& acmr) {
+  // Faces may index positions alone while the file has a different number
+  // of normals or texture coordinates; those cannot be packed per vertex.
+  if (parsed_data.positions != nullptr && !HasAlignedAttributes(parsed_data))
+    format = VertexFormat::Separate;
   MeshData mesh_data;
-  mesh_data.vertex_obj = make_unique<VertexObject>();
+  mesh_data.vertex_obj =
+      make_unique<VertexObject>(BufferUsage::Static, format);
+  mesh_data.vertex_obj->SetRetainCPUData(false);
   if (parsed_data.positions) {
     mesh_data.vertex_obj->UpdatePositions(std::move(parsed_data.positions));
   }
@@ -36,7 +105,114 @@ MeshData MeshLoader::Import(const std::string& filename) {
   }
 
   mesh_data.groups = std::move(parsed_data.groups);
+  mesh_data.acmr = acmr;
 
   return mesh_data;
 }
+
+// Copies the vertices a level still uses, at their renumbered places.
+template <class T>
+std::unique_ptr<std::vector<T>> CompactVertices(
+    const std::unique_ptr<std::vector<T>>& array,
+    const std::vector<unsigned int>& remap,
+    size_t num_used) {
+  if (array == nullptr)
+    return nullptr;
+  auto compacted = make_unique<std::vector<T>>(num_used);
+  for (size_t v = 0; v < array->size(); v++) {
+    if (remap[v] < num_used)
+      (*compacted)[remap[v]] = (*array)[v];
+  }
+  return compacted;
+}
+
+// Simplifies each range of the mesh to about ratio of its triangles.
+ObjParser::ParsedData SimplifyMesh(const ObjParser::ParsedData& data,
+                                   float ratio,
+                                   MeshOptimizer::Stats& acmr) {
+  ObjParser::ParsedData level;
+  level.groups = data.groups;
+  level.material_lib = data.material_lib;
+  level.indices = make_unique<IndexArray>();
+  IndexArray& indices = *level.indices;
+  size_t num_vertices = data.positions->size();
+  // The simplified ranges in their original order, for the ACMR.
+  IndexArray unoptimized;
+
+  std::vector<size_t> bounds = GetRangeBounds(data);
+  for (size_t i = 0; i + 1 < bounds.size(); i++) {
+    IndexArray range(data.indices->begin() + bounds[i],
+                     data.indices->begin() + bounds[i + 1]);
+    size_t target = static_cast<size_t>(range.size() * ratio) / 3 * 3;
+    IndexArray simplified =
+        MeshSimplifier::Simplify(*data.positions, range, target);
+    unoptimized.insert(unoptimized.end(), simplified.begin(),
+                       simplified.end());
+    MeshOptimizer::OptimizeVertexCache(simplified, num_vertices);
+    for (size_t j = 0; j < data.groups.size(); j++) {
+      if (data.groups[j].start_face_index == bounds[i]) {
+        level.groups[j].start_face_index = indices.size();
+        level.groups[j].num_indices = simplified.size();
+      }
+    }
+    indices.insert(indices.end(), simplified.begin(), simplified.end());
+  }
+  acmr.acmr_before = MeshOptimizer::ComputeACMR(unoptimized, num_vertices);
+  acmr.acmr_after = MeshOptimizer::ComputeACMR(indices, num_vertices);
+
+  if (!HasAlignedAttributes(data)) {
+    level.positions = make_unique<PositionArray>(*data.positions);
+    if (data.normals != nullptr)
+      level.normals = make_unique<NormalArray>(*data.normals);
+    if (data.tex_coords != nullptr)
+      level.tex_coords = make_unique<TexCoordArray>(*data.tex_coords);
+    return level;
+  }
+  std::vector<unsigned int> remap =
+      MeshOptimizer::OptimizeVertexFetch(indices, num_vertices);
+  size_t num_used = 0;
+  for (unsigned int idx : indices) {
+    num_used = std::max<size_t>(num_used, idx + 1);
+  }
+  level.positions = CompactVertices(data.positions, remap, num_used);
+  level.normals = CompactVertices(data.normals, remap, num_used);
+  level.tex_coords = CompactVertices(data.tex_coords, remap, num_used);
+  return level;
+}
+}  // namespace
+
+namespace GLOO {
+MeshData MeshLoader::Import(const std::string& filename,
+                            VertexFormat format) {
+  ObjParser::ParsedData parsed_data;
+  MeshOptimizer::Stats acmr = {0.0f, 0.0f};
+  if (!LoadParsedData(filename, parsed_data, acmr))
+    return {};
+  return CreateMeshData(std::move(parsed_data), format, acmr);
+}
+
+std::vector<MeshData> MeshLoader::ImportLevels(const std::string& filename,
+                                               size_t num_levels,
+                                               VertexFormat format) {
+  ObjParser::ParsedData parsed_data;
+  MeshOptimizer::Stats acmr = {0.0f, 0.0f};
+  if (!LoadParsedData(filename, parsed_data, acmr))
+    return {};
+
+  std::vector<MeshData> levels;
+  if (parsed_data.positions != nullptr && parsed_data.indices != nullptr) {
+    // Every level starts from the full mesh, so errors do not accumulate.
+    float ratio = 1.0f;
+    for (size_t i = 1; i < num_levels; i++) {
+      ratio *= 0.5f;
+      MeshOptimizer::Stats level_acmr = {0.0f, 0.0f};
+      ObjParser::ParsedData level =
+          SimplifyMesh(parsed_data, ratio, level_acmr);
+      levels.push_back(CreateMeshData(std::move(level), format, level_acmr));
+    }
+  }
+  levels.insert(levels.begin(),
+                CreateMeshData(std::move(parsed_data), format, acmr));
+  return levels;
+}
 }  // namespace GLOO
@@ -7,7 +7,18 @@
 namespace GLOO {
 class MeshLoader {
  public:
-  static MeshData Import(const std::string& filename);
+  // Loaded meshes are static, so their attributes are interleaved by default
+  // and their indices are stored as 16-bit values where they fit. Files
+  // whose attributes do not line up with their positions use separate
+  // buffers instead.
+  static MeshData Import(const std::string& filename,
+                         VertexFormat format = VertexFormat::Interleaved);
+  // The mesh followed by num_levels - 1 simplifications of it for a
+  // LevelOfDetailComponent, level i having about 1 / 2^i of the triangles.
+  static std::vector<MeshData> ImportLevels(
+      const std::string& filename,
+      size_t num_levels,
+      VertexFormat format = VertexFormat::Interleaved);
 };
 }  // namespace GLOO
 
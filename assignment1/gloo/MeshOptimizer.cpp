@@ -0,0 +1,244 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "utils.hpp"
+
+namespace {
+using namespace GLOO;
+
+// Tuning from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation", which
+// models an LRU cache of this size when scoring vertices.
+const int kScoringCacheSize = 32;
+const float kCacheDecayPower = 1.5f;
+const float kLastTriangleScore = 0.75f;
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+const unsigned int kMaxTabulatedValence = 32;
+
+class VertexScorer {
+ public:
+  VertexScorer() {
+    for (int i = 0; i < kScoringCacheSize; i++) {
+      if (i < 3) {
+        // The vertices of the last triangle get a fixed score, so that
+        // strips are not favored over fans.
+        cache_scores_[i] = kLastTriangleScore;
+      } else {
+        float scale = 1.0f / (kScoringCacheSize - 3);
+        cache_scores_[i] = std::pow(1.0f - (i - 3) * scale, kCacheDecayPower);
+      }
+    }
+    for (unsigned int i = 1; i <= kMaxTabulatedValence; i++) {
+      valence_scores_[i] = ValenceScore(i);
+    }
+  }
+
+  // Higher for vertices in the cache and for vertices with few triangles
+  // left, so that lone triangles are not left behind.
+  float Score(int cache_position, unsigned int remaining) const {
+    if (remaining == 0)
+      return -1.0f;
+    float score = cache_position >= 0 ? cache_scores_[cache_position] : 0.0f;
+    return score + (remaining <= kMaxTabulatedValence
+                        ? valence_scores_[remaining]
+                        : ValenceScore(remaining));
+  }
+
+ private:
+  static float ValenceScore(unsigned int remaining) {
+    return kValenceBoostScale *
+           std::pow(static_cast<float>(remaining), -kValenceBoostPower);
+  }
+
+  float cache_scores_[kScoringCacheSize];
+  float valence_scores_[kMaxTabulatedValence + 1];
+};
+}  // namespace
+
+namespace GLOO {
+float MeshOptimizer::ComputeACMR(const IndexArray& indices,
+                                 size_t num_vertices) {
+  size_t num_triangles = indices.size() / 3;
+  if (num_triangles == 0)
+    return 0.0f;
+  // Each vertex remembers the miss that brought it into the cache; it has
+  // been pushed out once kCacheSize later misses happened.
+  std::vector<size_t> inserted_at(num_vertices, 0);
+  size_t misses = 0;
+  for (unsigned int idx : indices) {
+    size_t& t = inserted_at[idx];
+    if (t == 0 || misses - t >= kCacheSize)
+      t = ++misses;
+  }
+  return static_cast<float>(misses) / num_triangles;
+}
+
+void MeshOptimizer::OptimizeVertexCache(IndexArray& indices,
+                                        size_t num_vertices,
+                                        size_t start_index,
+                                        size_t num_indices) {
+  size_t num_triangles = num_indices / 3;
+  if (num_triangles < 2)
+    return;
+  const unsigned int* triangles = indices.data() + start_index;
+  static const VertexScorer scorer;
+
+  // Triangles not emitted yet around each vertex, packed per vertex.
+  std::vector<unsigned int> remaining(num_vertices, 0);
+  for (size_t i = 0; i < 3 * num_triangles; i++) {
+    remaining[triangles[i]]++;
+  }
+  std::vector<size_t> adjacency_offsets(num_vertices + 1, 0);
+  for (size_t v = 0; v < num_vertices; v++) {
+    adjacency_offsets[v + 1] = adjacency_offsets[v] + remaining[v];
+  }
+  std::vector<unsigned int> adjacency(3 * num_triangles);
+  {
+    std::vector<size_t> fill(adjacency_offsets.begin(),
+                             adjacency_offsets.end() - 1);
+    for (size_t i = 0; i < 3 * num_triangles; i++) {
+      adjacency[fill[triangles[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+  }
+
+  std::vector<int> cache_positions(num_vertices, -1);
+  std::vector<float> vertex_scores(num_vertices);
+  for (size_t v = 0; v < num_vertices; v++) {
+    vertex_scores[v] = scorer.Score(-1, remaining[v]);
+  }
+  std::vector<bool> emitted(num_triangles, false);
+  long best = 0;
+  float best_score = -1.0f;
+  for (size_t t = 0; t < num_triangles; t++) {
+    const unsigned int* tri = triangles + 3 * t;
+    float score = vertex_scores[tri[0]] + vertex_scores[tri[1]] +
+                  vertex_scores[tri[2]];
+    if (score > best_score) {
+      best_score = score;
+      best = static_cast<long>(t);
+    }
+  }
+
+  IndexArray ordered;
+  ordered.reserve(3 * num_triangles);
+  unsigned int cache[kScoringCacheSize + 3];
+  int cache_size = 0;
+  size_t next_unemitted = 0;
+  for (size_t n = 0; n < num_triangles; n++) {
+    if (best < 0) {
+      // Nothing left around the cache; continue in input order.
+      while (emitted[next_unemitted])
+        next_unemitted++;
+      best = static_cast<long>(next_unemitted);
+    }
+    const unsigned int* tri = triangles + 3 * best;
+    emitted[best] = true;
+    for (int c = 0; c < 3; c++) {
+      unsigned int v = tri[c];
+      ordered.push_back(v);
+      unsigned int* begin = adjacency.data() + adjacency_offsets[v];
+      unsigned int* end = begin + remaining[v];
+      for (unsigned int* a = begin; a < end; a++) {
+        if (*a == static_cast<unsigned int>(best)) {
+          *a = *(end - 1);
+          remaining[v]--;
+          break;
+        }
+      }
+    }
+
+    // The triangle's vertices move to the front of the LRU cache.
+    unsigned int new_cache[kScoringCacheSize + 3];
+    int new_size = 0;
+    for (int c = 0; c < 3; c++) {
+      new_cache[new_size++] = tri[c];
+    }
+    for (int i = 0; i < cache_size; i++) {
+      unsigned int v = cache[i];
+      if (v != tri[0] && v != tri[1] && v != tri[2])
+        new_cache[new_size++] = v;
+    }
+    for (int i = 0; i < new_size; i++) {
+      unsigned int v = new_cache[i];
+      cache_positions[v] = i < kScoringCacheSize ? i : -1;
+      vertex_scores[v] = scorer.Score(cache_positions[v], remaining[v]);
+      cache[i] = v;
+    }
+
+    // Only triangles around touched vertices changed score, and the next
+    // triangle should come from the cache anyway.
+    best = -1;
+    best_score = -1.0f;
+    for (int i = 0; i < new_size; i++) {
+      unsigned int v = new_cache[i];
+      const unsigned int* begin = adjacency.data() + adjacency_offsets[v];
+      for (unsigned int k = 0; k < remaining[v]; k++) {
+        unsigned int t = begin[k];
+        const unsigned int* other = triangles + 3 * t;
+        float score = vertex_scores[other[0]] + vertex_scores[other[1]] +
+                      vertex_scores[other[2]];
+        if (i < kScoringCacheSize && score > best_score) {
+          best_score = score;
+          best = t;
+        }
+      }
+    }
+    cache_size = std::min(new_size, kScoringCacheSize);
+  }
+
+  std::copy(ordered.begin(), ordered.end(), indices.begin() + start_index);
+}
+
+std::vector<unsigned int> MeshOptimizer::OptimizeVertexFetch(
+    IndexArray& indices,
+    size_t num_vertices) {
+  const unsigned int kUnused = std::numeric_limits<unsigned int>::max();
+  std::vector<unsigned int> remap(num_vertices, kUnused);
+  unsigned int next = 0;
+  for (unsigned int& idx : indices) {
+    if (remap[idx] == kUnused)
+      remap[idx] = next++;
+    idx = remap[idx];
+  }
+  for (unsigned int& r : remap) {
+    if (r == kUnused)
+      r = next++;
+  }
+  return remap;
+}
+
+MeshOptimizer::Stats MeshOptimizer::Optimize(VertexObject& vertex_obj) {
+  if (!vertex_obj.HasIndices())
+    return {0.0f, 0.0f};
+  size_t num_vertices = vertex_obj.GetVertexCount();
+  auto indices = make_unique<IndexArray>(vertex_obj.GetIndices());
+  float acmr_before = ComputeACMR(*indices, num_vertices);
+  OptimizeVertexCache(*indices, num_vertices);
+  std::vector<unsigned int> remap = OptimizeVertexFetch(*indices, num_vertices);
+  float acmr_after = ComputeACMR(*indices, num_vertices);
+
+  auto positions = make_unique<PositionArray>(vertex_obj.GetPositions());
+  RemapVertices(remap, *positions);
+  vertex_obj.UpdatePositions(std::move(positions));
+  if (vertex_obj.HasNormals()) {
+    auto normals = make_unique<NormalArray>(vertex_obj.GetNormals());
+    RemapVertices(remap, *normals);
+    vertex_obj.UpdateNormals(std::move(normals));
+  }
+  if (vertex_obj.HasColors()) {
+    auto colors = make_unique<ColorArray>(vertex_obj.GetColors());
+    RemapVertices(remap, *colors);
+    vertex_obj.UpdateColors(std::move(colors));
+  }
+  if (vertex_obj.HasTexCoors()) {
+    auto tex_coords = make_unique<TexCoordArray>(vertex_obj.GetTexCoords());
+    RemapVertices(remap, *tex_coords);
+    vertex_obj.UpdateTexCoord(std::move(tex_coords));
+  }
+  vertex_obj.UpdateIndices(std::move(indices));
+  return {acmr_before, acmr_after};
+}
+}  // namespace GLOO
@@ -0,0 +1,250 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+using namespace GLOO;
+
+// Symmetric 4x4 matrix summing squared distances to planes.
+struct Quadric {
+  double a2{0}, ab{0}, ac{0}, ad{0};
+  double b2{0}, bc{0}, bd{0};
+  double c2{0}, cd{0};
+  double d2{0};
+
+  void AddPlane(const glm::dvec3& n, double d, double weight) {
+    a2 += weight * n.x * n.x;
+    ab += weight * n.x * n.y;
+    ac += weight * n.x * n.z;
+    ad += weight * n.x * d;
+    b2 += weight * n.y * n.y;
+    bc += weight * n.y * n.z;
+    bd += weight * n.y * d;
+    c2 += weight * n.z * n.z;
+    cd += weight * n.z * d;
+    d2 += weight * d * d;
+  }
+
+  void Add(const Quadric& q) {
+    a2 += q.a2;
+    ab += q.ab;
+    ac += q.ac;
+    ad += q.ad;
+    b2 += q.b2;
+    bc += q.bc;
+    bd += q.bd;
+    c2 += q.c2;
+    cd += q.cd;
+    d2 += q.d2;
+  }
+
+  double Evaluate(const glm::vec3& p) const {
+    double x = p.x, y = p.y, z = p.z;
+    return a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x +
+           b2 * y * y + 2 * bc * y * z + 2 * bd * y + c2 * z * z +
+           2 * cd * z + d2;
+  }
+};
+
+struct Collapse {
+  double cost;
+  unsigned int from;
+  unsigned int to;
+
+  bool operator<(const Collapse& other) const {
+    return cost < other.cost;
+  }
+};
+
+struct PositionHash {
+  size_t operator()(const glm::vec3& p) const {
+    // Adding zero turns -0 into 0, which compares equal to it.
+    glm::vec3 q = p + glm::vec3(0.0f);
+    uint32_t bits[3];
+    std::memcpy(bits, &q[0], sizeof(bits));
+    return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^
+           (bits[2] * 83492791u);
+  }
+};
+
+uint64_t EdgeKey(unsigned int a, unsigned int b) {
+  if (a > b)
+    std::swap(a, b);
+  return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+glm::vec3 TriangleNormal(const glm::vec3& p0,
+                         const glm::vec3& p1,
+                         const glm::vec3& p2) {
+  return glm::cross(p1 - p0, p2 - p0);
+}
+
+// Marks vertices that must not move: seams, open borders and non-manifold
+// edges. Edges are compared by position so seams do not look like borders.
+void LockBoundaries(const PositionArray& positions,
+                    const IndexArray& indices,
+                    std::vector<bool>& locked) {
+  std::unordered_map<glm::vec3, unsigned int, PositionHash> first_at;
+  std::vector<unsigned int> canonical(positions.size());
+  std::vector<unsigned int> copies(positions.size(), 0);
+  for (size_t v = 0; v < positions.size(); v++) {
+    auto inserted =
+        first_at.emplace(positions[v], static_cast<unsigned int>(v));
+    canonical[v] = inserted.first->second;
+    copies[canonical[v]]++;
+  }
+
+  std::unordered_map<uint64_t, unsigned int> edge_counts;
+  edge_counts.reserve(indices.size());
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    for (int e = 0; e < 3; e++) {
+      unsigned int a = canonical[indices[i + e]];
+      unsigned int b = canonical[indices[i + (e + 1) % 3]];
+      edge_counts[EdgeKey(a, b)]++;
+    }
+  }
+  std::vector<bool> locked_position(positions.size(), false);
+  for (const auto& edge : edge_counts) {
+    if (edge.second != 2) {
+      locked_position[edge.first >> 32] = true;
+      locked_position[edge.first & 0xffffffffu] = true;
+    }
+  }
+  for (size_t v = 0; v < positions.size(); v++) {
+    if (copies[canonical[v]] > 1 || locked_position[canonical[v]])
+      locked[v] = true;
+  }
+}
+}  // namespace
+
+namespace GLOO {
+IndexArray MeshSimplifier::Simplify(const PositionArray& positions,
+                                    const IndexArray& indices,
+                                    size_t target_index_count) {
+  size_t num_vertices = positions.size();
+  std::vector<bool> is_locked(num_vertices, false);
+  LockBoundaries(positions, indices, is_locked);
+
+  // Area-weighted planes of the triangles around each vertex.
+  std::vector<Quadric> quadrics(num_vertices);
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    const glm::vec3& p0 = positions[indices[i]];
+    glm::dvec3 n(TriangleNormal(p0, positions[indices[i + 1]],
+                                positions[indices[i + 2]]));
+    double length = glm::length(n);
+    if (length == 0.0)
+      continue;
+    n /= length;
+    double d = -glm::dot(n, glm::dvec3(p0));
+    for (int c = 0; c < 3; c++) {
+      quadrics[indices[i + c]].AddPlane(n, d, 0.5 * length);
+    }
+  }
+
+  IndexArray result = indices;
+  std::vector<unsigned int> adjacency_offsets(num_vertices + 1);
+  std::vector<unsigned int> adjacency;
+  std::vector<Collapse> collapses;
+  std::vector<unsigned int> collapse_to(num_vertices);
+  std::vector<bool> touched(num_vertices);
+  while (result.size() > target_index_count) {
+    // Triangles around each vertex.
+    std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+    for (unsigned int v : result) {
+      adjacency_offsets[v + 1]++;
+    }
+    for (size_t v = 0; v < num_vertices; v++) {
+      adjacency_offsets[v + 1] += adjacency_offsets[v];
+    }
+    adjacency.resize(result.size());
+    {
+      std::vector<unsigned int> fill(adjacency_offsets.begin(),
+                                     adjacency_offsets.end() - 1);
+      for (size_t i = 0; i < result.size(); i++) {
+        adjacency[fill[result[i]]++] = static_cast<unsigned int>(i / 3);
+      }
+    }
+
+    collapses.clear();
+    for (size_t i = 0; i < result.size(); i += 3) {
+      for (int e = 0; e < 3; e++) {
+        unsigned int a = result[i + e];
+        unsigned int b = result[i + (e + 1) % 3];
+        Quadric q = quadrics[a];
+        q.Add(quadrics[b]);
+        if (!is_locked[a])
+          collapses.push_back({q.Evaluate(positions[b]), a, b});
+        if (!is_locked[b])
+          collapses.push_back({q.Evaluate(positions[a]), b, a});
+      }
+    }
+    std::sort(collapses.begin(), collapses.end());
+
+    // Collapses in one pass must not share triangles, so each locks the
+    // neighborhood of the vertex it removes.
+    for (size_t v = 0; v < num_vertices; v++) {
+      collapse_to[v] = static_cast<unsigned int>(v);
+    }
+    std::fill(touched.begin(), touched.end(), false);
+    size_t triangles_to_remove = (result.size() - target_index_count + 2) / 3;
+    size_t removed = 0;
+    for (const Collapse& c : collapses) {
+      if (removed >= triangles_to_remove)
+        break;
+      if (touched[c.from] || touched[c.to])
+        continue;
+
+      bool flips = false;
+      size_t shared = 0;
+      for (unsigned int k = adjacency_offsets[c.from];
+           k < adjacency_offsets[c.from + 1] && !flips; k++) {
+        const unsigned int* tri = &result[3 * adjacency[k]];
+        if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) {
+          shared++;
+          continue;
+        }
+        glm::vec3 p[3], q[3];
+        for (int j = 0; j < 3; j++) {
+          p[j] = positions[tri[j]];
+          q[j] = tri[j] == c.from ? positions[c.to] : p[j];
+        }
+        flips = glm::dot(TriangleNormal(p[0], p[1], p[2]),
+                         TriangleNormal(q[0], q[1], q[2])) <= 0.0f;
+      }
+      if (flips)
+        continue;
+
+      collapse_to[c.from] = c.to;
+      quadrics[c.to].Add(quadrics[c.from]);
+      for (unsigned int k = adjacency_offsets[c.from];
+           k < adjacency_offsets[c.from + 1]; k++) {
+        const unsigned int* tri = &result[3 * adjacency[k]];
+        for (int j = 0; j < 3; j++) {
+          touched[tri[j]] = true;
+        }
+      }
+      removed += shared;
+    }
+    if (removed == 0)
+      break;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < result.size(); i += 3) {
+      unsigned int a = collapse_to[result[i]];
+      unsigned int b = collapse_to[result[i + 1]];
+      unsigned int c = collapse_to[result[i + 2]];
+      if (a == b || b == c || c == a)
+        continue;
+      result[kept++] = a;
+      result[kept++] = b;
+      result[kept++] = c;
+    }
+    result.resize(kept);
+  }
+  return result;
+}
+}  // namespace GLOO
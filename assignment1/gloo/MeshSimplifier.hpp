@@ -0,0 +1,23 @@
+#ifndef GLOO_MESH_SIMPLIFIER_H_
+#define GLOO_MESH_SIMPLIFIER_H_
+
+#include "alias_types.hpp"
+
+namespace GLOO {
+// Reduces triangle counts by edge collapse, cheapest quadric error first
+// (Garland and Heckbert). Vertices are merged into neighbors rather than
+// moved, so the result indexes the original vertex arrays.
+class MeshSimplifier {
+ public:
+  // Collapses until at most target_index_count indices remain or no more
+  // collapses are allowed. Vertices on open borders and on attribute seams
+  // (several vertices at one position) stay in place, so separately
+  // simplified parts of a mesh still meet. Collapses that would flip a
+  // triangle are skipped.
+  static IndexArray Simplify(const PositionArray& positions,
+                             const IndexArray& indices,
+                             size_t target_index_count);
+};
+}  // namespace GLOO
+
+#endif
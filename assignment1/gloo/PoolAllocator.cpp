@@ -0,0 +1,64 @@
+#include "PoolAllocator.hpp"
+
+#include <new>
+
+namespace {
+using GLOO::PoolAllocator;
+
+// Block sizes are multiples of kGranularity, which keeps every block as
+// aligned as ::operator new would.
+const size_t kGranularity = alignof(std::max_align_t);
+const size_t kNumSizeClasses = PoolAllocator::kMaxPooledSize / kGranularity;
+// Blocks carved from the system at once when a free list runs dry.
+const size_t kBlocksPerChunk = 32;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// Never destroyed, so that objects freed during static destruction still
+// find their pool.
+FreeBlock** GetFreeLists() {
+  static FreeBlock** free_lists = new FreeBlock*[kNumSizeClasses]();
+  return free_lists;
+}
+
+size_t GetSizeClass(size_t size) {
+  return size == 0 ? 0 : (size - 1) / kGranularity;
+}
+}  // namespace
+
+namespace GLOO {
+void* PoolAllocator::Allocate(size_t size) {
+  if (size > kMaxPooledSize)
+    return ::operator new(size);
+  size_t size_class = GetSizeClass(size);
+  FreeBlock*& head = GetFreeLists()[size_class];
+  if (head == nullptr) {
+    size_t block_size = (size_class + 1) * kGranularity;
+    char* chunk = static_cast<char*>(::operator new(block_size *
+                                                    kBlocksPerChunk));
+    for (size_t i = 0; i < kBlocksPerChunk; i++) {
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * block_size);
+      block->next = head;
+      head = block;
+    }
+  }
+  FreeBlock* block = head;
+  head = block->next;
+  return block;
+}
+
+void PoolAllocator::Deallocate(void* ptr, size_t size) {
+  if (ptr == nullptr)
+    return;
+  if (size > kMaxPooledSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  FreeBlock*& head = GetFreeLists()[GetSizeClass(size)];
+  FreeBlock* block = static_cast<FreeBlock*>(ptr);
+  block->next = head;
+  head = block;
+}
+}  // namespace GLOO
@@ -0,0 +1,22 @@
+#ifndef GLOO_POOL_ALLOCATOR_H_
+#define GLOO_POOL_ALLOCATOR_H_
+
+#include <cstddef>
+
+namespace GLOO {
+// Hands out memory blocks from per-size free lists. Freed blocks go back to
+// their list instead of to the system, so objects that are created and
+// destroyed over and over, like scene nodes and components, keep reusing
+// the same memory. Blocks above kMaxPooledSize bytes bypass the pools.
+// Not thread-safe: scene graphs are built and edited on the main thread.
+class PoolAllocator {
+ public:
+  static void* Allocate(size_t size);
+  // size must be the size passed to Allocate.
+  static void Deallocate(void* ptr, size_t size);
+
+  static const size_t kMaxPooledSize = 2048;
+};
+}  // namespace GLOO
+
+#endif
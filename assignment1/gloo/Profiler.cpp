@@ -0,0 +1,225 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "external.hpp"
+#include "utils.hpp"
+
+namespace {
+void WriteJSONString(std::ofstream& ofs, const char* str) {
+  ofs << '"';
+  for (const char* c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\')
+      ofs << '\\';
+    ofs << *c;
+  }
+  ofs << '"';
+}
+}  // namespace
+
+namespace GLOO {
+Profiler::Profiler() : epoch_(std::chrono::steady_clock::now()) {
+  std::strcpy(trace_filename_, "trace.json");
+}
+
+double Profiler::Now() const {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - epoch_)
+      .count();
+}
+
+void Profiler::BeginFrame() {
+  frame_start_us_ = Now();
+}
+
+void Profiler::EndFrame() {
+  CollectQueries();
+  if (!paused_)
+    Record("Frame", false, frame_start_us_, Now() - frame_start_us_,
+           frame_index_);
+  frame_index_++;
+}
+
+void Profiler::DeleteQueries() {
+  for (const GpuQuery& query : pending_queries_) {
+    free_queries_.push_back(query.id);
+  }
+  pending_queries_.clear();
+  if (!free_queries_.empty()) {
+    GL_CHECK(glDeleteQueries(static_cast<GLsizei>(free_queries_.size()),
+                             free_queries_.data()));
+  }
+  free_queries_.clear();
+}
+
+void Profiler::Record(const char* name,
+                      bool gpu,
+                      double start_us,
+                      double duration_us,
+                      size_t frame) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trace_.push_back(
+      {name, gpu, gpu ? 0 : GetThreadIndex(), start_us, duration_us, frame});
+  while (!trace_.empty() && trace_.front().frame + kTraceFrames < frame) {
+    trace_.pop_front();
+  }
+
+  // The same name on the CPU and the GPU makes two timers.
+  std::string key = std::string(gpu ? "GPU " : "CPU ") + name;
+  auto it = timer_indices_.find(key);
+  if (it == timer_indices_.end()) {
+    it = timer_indices_.emplace(key, timers_.size()).first;
+    TimerStats stats;
+    stats.name = name;
+    stats.gpu = gpu;
+    stats.history_ms.resize(kHistorySize, 0.0f);
+    stats.pending_frame = frame;
+    timers_.push_back(std::move(stats));
+  }
+  TimerStats& stats = timers_[it->second];
+  if (stats.pending_frame != frame) {
+    stats.history_ms[stats.next] = static_cast<float>(stats.pending_us / 1000);
+    stats.next = (stats.next + 1) % kHistorySize;
+    stats.pending_frame = frame;
+    stats.pending_us = 0;
+  }
+  stats.pending_us += duration_us;
+}
+
+int Profiler::GetThreadIndex() {
+  auto inserted = thread_indices_.emplace(
+      std::this_thread::get_id(), static_cast<int>(thread_indices_.size()));
+  return inserted.first->second;
+}
+
+GLuint Profiler::AcquireQuery() {
+  if (free_queries_.empty()) {
+    GLuint id;
+    GL_CHECK(glGenQueries(1, &id));
+    return id;
+  }
+  GLuint id = free_queries_.back();
+  free_queries_.pop_back();
+  return id;
+}
+
+void Profiler::CollectQueries() {
+  // Queries finish in the order they were issued.
+  while (!pending_queries_.empty()) {
+    const GpuQuery& query = pending_queries_.front();
+    // Past kGpuLatency frames the result is waited for.
+    if (query.frame + kGpuLatency > frame_index_) {
+      GLint available = 0;
+      GL_CHECK(glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE,
+                                  &available));
+      if (!available)
+        break;
+    }
+    GLuint64 elapsed_ns = 0;
+    GL_CHECK(glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsed_ns));
+    // The GPU start is unknown; the event is placed at submission.
+    Record(query.name, true, query.start_us, elapsed_ns / 1000.0, query.frame);
+    free_queries_.push_back(query.id);
+    pending_queries_.pop_front();
+  }
+}
+
+void Profiler::DrawGUI() {
+  ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+  ImGui::Begin("Profiler");
+  bool paused = paused_;
+  if (ImGui::Checkbox("Pause", &paused))
+    paused_ = paused;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const TimerStats& stats : timers_) {
+      float total = 0.0f, peak = 0.0f;
+      for (float ms : stats.history_ms) {
+        total += ms;
+        peak = std::max(peak, ms);
+      }
+      char overlay[64];
+      std::snprintf(overlay, sizeof(overlay), "avg %.2f ms, max %.2f ms",
+                    total / kHistorySize, peak);
+      ImGui::Text("%s %s", stats.gpu ? "GPU" : "CPU", stats.name.c_str());
+      ImGui::PushID(&stats);
+      ImGui::PlotHistogram("", stats.history_ms.data(),
+                           static_cast<int>(kHistorySize),
+                           static_cast<int>(stats.next), overlay, 0.0f,
+                           std::max(peak, 1.0f), ImVec2(0, 40));
+      ImGui::PopID();
+    }
+  }
+
+  ImGui::InputText("File", trace_filename_, sizeof(trace_filename_));
+  if (ImGui::SmallButton("Export Chrome trace")) {
+    export_status_ = ExportChromeTrace(trace_filename_)
+                         ? std::string("Wrote ") + trace_filename_
+                         : std::string("Cannot write ") + trace_filename_;
+  }
+  if (!export_status_.empty())
+    ImGui::Text("%s", export_status_.c_str());
+  ImGui::End();
+}
+
+bool Profiler::ExportChromeTrace(const std::string& filename) const {
+  std::ofstream ofs(filename);
+  if (!ofs)
+    return false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Complete ("X") events; GPU timers get a process of their own.
+  ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+      << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,"
+         "\"args\":{\"name\":\"CPU\"}},\n"
+      << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+         "\"args\":{\"name\":\"GPU\"}}";
+  ofs.precision(3);
+  ofs << std::fixed;
+  for (const TraceEvent& event : trace_) {
+    ofs << ",\n{\"name\":";
+    WriteJSONString(ofs, event.name);
+    ofs << ",\"ph\":\"X\",\"pid\":" << (event.gpu ? 1 : 0)
+        << ",\"tid\":" << event.thread << ",\"ts\":" << event.start_us
+        << ",\"dur\":" << event.duration_us
+        << ",\"args\":{\"frame\":" << event.frame << "}}";
+  }
+  ofs << "\n]}\n";
+  return static_cast<bool>(ofs);
+}
+
+ScopedTimer::ScopedTimer(const char* name)
+    : name_(name),
+      frame_(Profiler::GetInstance().frame_index_),
+      start_us_(Profiler::GetInstance().Now()) {
+}
+
+ScopedTimer::~ScopedTimer() {
+  Profiler& profiler = Profiler::GetInstance();
+  if (!profiler.paused_)
+    profiler.Record(name_, false, start_us_, profiler.Now() - start_us_,
+                    frame_);
+}
+
+ScopedGpuTimer::ScopedGpuTimer(const char* name) : active_(false) {
+  Profiler& profiler = Profiler::GetInstance();
+  if (profiler.gpu_scope_active_ || profiler.paused_)
+    return;
+  GLuint id = profiler.AcquireQuery();
+  GL_CHECK(glBeginQuery(GL_TIME_ELAPSED, id));
+  profiler.pending_queries_.push_back(
+      {id, name, profiler.Now(), profiler.frame_index_});
+  profiler.gpu_scope_active_ = true;
+  active_ = true;
+}
+
+ScopedGpuTimer::~ScopedGpuTimer() {
+  if (!active_)
+    return;
+  GL_CHECK(glEndQuery(GL_TIME_ELAPSED));
+  Profiler::GetInstance().gpu_scope_active_ = false;
+}
+}  // namespace GLOO
@@ -0,0 +1,141 @@
+#ifndef GLOO_PROFILER_H_
+#define GLOO_PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace GLOO {
+// Collects CPU and GPU timings of named scopes, shows them as rolling
+// histograms in an ImGui window and exports the last frames as a Chrome
+// trace (chrome://tracing or https://ui.perfetto.dev).
+//
+// Time a scope with a ScopedTimer or ScopedGpuTimer. Names must be string
+// literals, since events keep the pointer.
+class Profiler {
+ public:
+  // Singleton design pattern, like InputManager.
+  static Profiler& GetInstance() {
+    static Profiler _instance;
+    return _instance;
+  }
+
+  Profiler(const Profiler&) = delete;
+  void operator=(const Profiler&) = delete;
+
+  // Bracket each frame; EndFrame also collects finished GPU timers.
+  void BeginFrame();
+  void EndFrame();
+  // The query objects belong to the GL context, so they must go first.
+  void DeleteQueries();
+
+  void DrawGUI();
+  // Writes the events of the last kTraceFrames frames. Returns false if the
+  // file cannot be written.
+  bool ExportChromeTrace(const std::string& filename) const;
+
+ private:
+  friend class ScopedTimer;
+  friend class ScopedGpuTimer;
+
+  // Samples kept per timer for the histograms.
+  static const size_t kHistorySize = 120;
+  static const size_t kTraceFrames = 300;
+  // Frames after which a GPU result is expected to be ready.
+  static const size_t kGpuLatency = 3;
+
+  struct TraceEvent {
+    const char* name;
+    bool gpu;
+    int thread;
+    double start_us;
+    double duration_us;
+    size_t frame;
+  };
+  struct TimerStats {
+    std::string name;
+    bool gpu;
+    std::vector<float> history_ms;
+    size_t next{0};
+    // Scopes may run several times a frame; their times are summed.
+    size_t pending_frame{0};
+    double pending_us{0};
+  };
+  struct GpuQuery {
+    GLuint id;
+    const char* name;
+    double start_us;
+    size_t frame;
+  };
+
+  Profiler();
+
+  double Now() const;
+  void Record(const char* name,
+              bool gpu,
+              double start_us,
+              double duration_us,
+              size_t frame);
+  int GetThreadIndex();
+  GLuint AcquireQuery();
+  void CollectQueries();
+
+  std::chrono::steady_clock::time_point epoch_;
+  std::atomic<size_t> frame_index_{0};
+  double frame_start_us_{0};
+
+  mutable std::mutex mutex_;
+  std::deque<TraceEvent> trace_;
+  std::vector<TimerStats> timers_;
+  std::unordered_map<std::string, size_t> timer_indices_;
+  std::unordered_map<std::thread::id, int> thread_indices_;
+
+  std::deque<GpuQuery> pending_queries_;
+  std::vector<GLuint> free_queries_;
+  // GL_TIME_ELAPSED queries cannot nest; inner GPU scopes are not timed.
+  bool gpu_scope_active_{false};
+
+  // Freezes the histograms and the trace for a closer look.
+  std::atomic<bool> paused_{false};
+  char trace_filename_[256];
+  std::string export_status_;
+};
+
+// Times the enclosing scope on the CPU.
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const char* name);
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  const char* name_;
+  size_t frame_;
+  double start_us_;
+};
+
+// Times the GL commands issued in the enclosing scope with a GL_TIME_ELAPSED
+// query. The result is read back a few frames later, so it never stalls.
+class ScopedGpuTimer {
+ public:
+  explicit ScopedGpuTimer(const char* name);
+  ~ScopedGpuTimer();
+
+  ScopedGpuTimer(const ScopedGpuTimer&) = delete;
+  ScopedGpuTimer& operator=(const ScopedGpuTimer&) = delete;
+
+ private:
+  bool active_;
+};
+}  // namespace GLOO
+
+#endif
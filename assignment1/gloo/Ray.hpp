@@ -0,0 +1,18 @@
+#ifndef GLOO_RAY_H_
+#define GLOO_RAY_H_
+
+#include <glm/glm.hpp>
+
+namespace GLOO {
+struct Ray {
+  glm::vec3 origin;
+  // Not necessarily normalized; hit distances are in units of its length.
+  glm::vec3 direction;
+
+  glm::vec3 At(float t) const {
+    return origin + t * direction;
+  }
+};
+}  // namespace GLOO
+
+#endif
@@ -5,14 +5,45 @@
 #include <glm/gtx/string_cast.hpp>
 
 #include "Application.hpp"
+#include "Frustum.hpp"
+#include "Profiler.hpp"
 #include "Scene.hpp"
 #include "utils.hpp"
 #include "gl_wrapper/BindGuard.hpp"
 #include "shaders/ShaderProgram.hpp"
 #include "components/ShadingComponent.hpp"
 #include "components/CameraComponent.hpp"
+#include "components/ComponentRegistry.hpp"
+#include "components/LevelOfDetailComponent.hpp"
 #include "debug/PrimitiveFactory.hpp"
 
+namespace {
+using namespace GLOO;
+
+// Whether node and all of its ancestors are active and root is the topmost.
+bool IsActiveUnder(const SceneNode& node, const SceneNode& root) {
+  const SceneNode* ptr = &node;
+  while (ptr->GetParentPtr() != nullptr) {
+    if (!ptr->IsActive())
+      return false;
+    ptr = ptr->GetParentPtr();
+  }
+  return ptr == &root && root.IsActive();
+}
+
+// Same components as root.GetComponentPtrsInChildren<T>(), found through
+// the registry instead of by walking the whole tree.
+template <class T>
+std::vector<T*> GetActiveComponentPtrs(const SceneNode& root) {
+  std::vector<T*> result;
+  for (ComponentBase* component : ComponentRegistry::GetComponents<T>()) {
+    if (IsActiveUnder(*component->GetNodePtr(), root))
+      result.push_back(static_cast<T*>(component));
+  }
+  return result;
+}
+}  // namespace
+
 namespace GLOO {
 Renderer::Renderer(Application& application) : application_(application) {
   UNUSED(application_);
@@ -36,32 +67,37 @@ void Renderer::Render(const Scene& scene) const {
 }
 
 Renderer::RenderingInfo Renderer::RetrieveRenderingInfo(
-    const Scene& scene) const {
+    const Scene& scene,
+    const CameraComponent& camera) const {
+  ScopedTimer timer("Renderer::RetrieveRenderingInfo");
+  // Only nodes whose world bounds intersect the view frustum, found through
+  // the scene's spatial index instead of visiting every node.
+  Frustum frustum(camera.GetProjectionMatrix() * camera.GetViewMatrix());
+  std::vector<SceneNode*> visible_nodes;
+  scene.GetSpatialIndex().Query(frustum, visible_nodes);
+
   RenderingInfo info;
-  const SceneNode& root = scene.GetRootNode();
-  // TODO: Below is an inefficient implementation that computes local-to-world
-  // matrices for all nodes in the tree. Implement a more efficient version
-  // with O(n) matrix multiplications that recursively compute the
-  // local-to-world matrices.
-  //
-  // Hint: you shouldn't need root.GetComponentPtrsInChildren. Instead you
-  // should create your own recursive function that collects
-  // std::pair<RenderingComponent*, glm::mat4>.
-  auto robj_ptrs = root.GetComponentPtrsInChildren<RenderingComponent>();
-  for (auto ptr : robj_ptrs) {
-    auto node_ptr = ptr->GetNodePtr();
-    if (node_ptr->IsActive())
-      info.emplace_back(ptr, node_ptr->GetTransform().GetLocalToWorldMatrix());
+  info.reserve(visible_nodes.size());
+  for (SceneNode* node_ptr : visible_nodes) {
+    // Null if the node was deactivated since the last scene update.
+    auto robj_ptr = node_ptr->GetComponentPtr<RenderingComponent>();
+    if (robj_ptr == nullptr)
+      continue;
+    glm::mat4 local_to_world = node_ptr->GetTransform().GetLocalToWorldMatrix();
+    auto lod_ptr = node_ptr->GetComponentPtr<LevelOfDetailComponent>();
+    if (lod_ptr != nullptr)
+      lod_ptr->SelectLevel(camera, local_to_world);
+    info.emplace_back(robj_ptr, local_to_world);
   }
   return info;
 }
 
 void Renderer::RenderScene(const Scene& scene) const {
+  ScopedTimer timer("Renderer::RenderScene");
   GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 
   const SceneNode& root = scene.GetRootNode();
-  auto rendering_info = RetrieveRenderingInfo(scene);
-  auto light_ptrs = root.GetComponentPtrsInChildren<LightComponent>();
+  auto light_ptrs = GetActiveComponentPtrs<LightComponent>(root);
   if (light_ptrs.size() == 0) {
     // Make sure there are at least 2 passes of we don't forget to set color
     // mask back.
@@ -69,6 +105,8 @@ void Renderer::RenderScene(const Scene& scene) const {
   }
 
   CameraComponent* camera = scene.GetActiveCameraPtr();
+  // Both the depth pass and the lighting passes only see visible geometry.
+  auto rendering_info = RetrieveRenderingInfo(scene, *camera);
 
   {
     // Here we first do a depth pass (note that this has nothing to do with the
@@ -77,6 +115,8 @@ void Renderer::RenderScene(const Scene& scene) const {
     // safely leave this pass here without understanding/modifying it, for
     // assignment 5. If you are interested in learning more, see
     // https://www.khronos.org/opengl/wiki/Early_Fragment_Test#Optimization
+    ScopedTimer pass_timer("Depth pass");
+    ScopedGpuTimer gpu_timer("Depth pass");
 
     GL_CHECK(glDepthMask(GL_TRUE));
     bool color_mask = GL_FALSE;
@@ -105,6 +145,8 @@ void Renderer::RenderScene(const Scene& scene) const {
 
   // The real shadow map/Phong shading passes.
   for (size_t light_id = 0; light_id < light_ptrs.size(); light_id++) {
+    ScopedTimer pass_timer("Lighting passes");
+    ScopedGpuTimer gpu_timer("Lighting passes");
 
     GL_CHECK(glDepthMask(GL_FALSE));
     bool color_mask = GL_TRUE;
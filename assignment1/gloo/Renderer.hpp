@@ -9,6 +9,7 @@
 namespace GLOO {
 class Scene;
 class Application;
+class CameraComponent;
 class Renderer {
  public:
   Renderer(Application& application);
@@ -19,7 +20,8 @@ class Renderer {
   void RenderScene(const Scene& scene) const;
   void SetRenderingOptions() const;
 
-  RenderingInfo RetrieveRenderingInfo(const Scene& scene) const;
+  RenderingInfo RetrieveRenderingInfo(const Scene& scene,
+                                      const CameraComponent& camera) const;
 
 
   Application& application_;
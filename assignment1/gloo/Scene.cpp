@@ -1,16 +1,59 @@
 #include "Scene.hpp"
 
+#include "components/RenderingComponent.hpp"
+
 namespace GLOO {
 
 void Scene::Update(double delta_time) {
-  RecursiveUpdate(*root_node_, delta_time);
+  RecursiveUpdate(*root_node_, delta_time, true, false);
 }
 
-void Scene::RecursiveUpdate(SceneNode& node, double delta_time) {
+void Scene::RecursiveUpdate(SceneNode& node,
+                            double delta_time,
+                            bool active,
+                            bool parent_moved) {
   node.Update(delta_time);
-  size_t child_count = node.GetChildrenCount();
-  for (size_t i = 0; i < child_count; i++) {
-    RecursiveUpdate(node.GetChild(i), delta_time);
+  active = active && node.IsActive();
+  // Moving a node moves the world bounds of its whole subtree.
+  unsigned int version = node.GetTransform().GetVersion();
+  bool moved = parent_moved || node.synced_transform_version_ != version;
+  node.synced_transform_version_ = version;
+  SyncSpatialIndex(node, active, moved);
+  // Updates may remove later siblings, so the count is read every time.
+  for (size_t i = 0; i < node.GetChildrenCount(); i++) {
+    RecursiveUpdate(node.GetChild(i), delta_time, active, moved);
+  }
+}
+
+void Scene::SyncSpatialIndex(SceneNode& node, bool active, bool moved) {
+  SceneNode::SpatialProxy& proxy = node.spatial_proxy_;
+  auto rendering_ptr = node.GetComponentPtr<RenderingComponent>();
+  VertexObject* vertex_obj =
+      active && rendering_ptr != nullptr ? rendering_ptr->GetVertexObjectPtr()
+                                         : nullptr;
+  if (vertex_obj == nullptr || vertex_obj->GetBounds().IsEmpty()) {
+    // Nothing to draw or pick.
+    if (proxy.index != nullptr) {
+      spatial_index_.Remove(proxy.leaf);
+      proxy = SceneNode::SpatialProxy();
+    }
+    return;
+  }
+
+  if (proxy.index != nullptr && proxy.vertex_obj == vertex_obj && !moved &&
+      proxy.bounds_version == vertex_obj->GetBoundsVersion()) {
+    return;
+  }
+
+  BoundingBox bounds = rendering_ptr->GetWorldBounds(
+      node.GetTransform().GetLocalToWorldMatrix());
+  if (proxy.index == nullptr) {
+    proxy.index = &spatial_index_;
+    proxy.leaf = spatial_index_.Insert(bounds, &node);
+  } else {
+    spatial_index_.Update(proxy.leaf, bounds);
   }
+  proxy.vertex_obj = vertex_obj;
+  proxy.bounds_version = vertex_obj->GetBoundsVersion();
 }
 }  // namespace GLOO
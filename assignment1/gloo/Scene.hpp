@@ -1,9 +1,11 @@
 #ifndef GLOO_SCENE_H_
 #define GLOO_SCENE_H_
 
+#include <functional>
 #include <vector>
 #include <memory>
 
+#include "BoundingVolumeHierarchy.hpp"
 #include "SceneNode.hpp"
 #include "components/CameraComponent.hpp"
 
@@ -26,11 +28,28 @@ class Scene {
   CameraComponent* GetActiveCameraPtr() const {
     return active_camera_ptr_;
   }
+  // World bounds of active rendering nodes, refit during Update for nodes
+  // whose transform, ancestors' transforms or vertex object changed.
+  const BoundingVolumeHierarchy& GetSpatialIndex() const {
+    return spatial_index_;
+  }
+  // Nearest active rendering node hit by the ray, or nullptr.
+  SceneNode* Pick(const Ray& ray,
+                  const std::function<bool(const SceneNode&)>& filter = nullptr,
+                  float* distance = nullptr) const {
+    return spatial_index_.RayCast(ray, filter, distance);
+  }
   void Update(double delta_time);
 
  private:
-  void RecursiveUpdate(SceneNode& node, double delta_time);
+  void RecursiveUpdate(SceneNode& node,
+                       double delta_time,
+                       bool active,
+                       bool parent_moved);
+  void SyncSpatialIndex(SceneNode& node, bool active, bool moved);
 
+  // Declared before the root so that nodes can unregister on destruction.
+  BoundingVolumeHierarchy spatial_index_;
   std::unique_ptr<SceneNode> root_node_;
   CameraComponent* active_camera_ptr_;
 };
@@ -2,18 +2,49 @@
 
 #include <glm/gtx/string_cast.hpp>
 
+#include "BoundingVolumeHierarchy.hpp"
+
 namespace GLOO {
 SceneNode::SceneNode() : transform_(*this), parent_(nullptr), active_(true) {
 }
 
+SceneNode::~SceneNode() {
+  if (spatial_proxy_.index != nullptr)
+    spatial_proxy_.index->Remove(spatial_proxy_.leaf);
+}
+
 void SceneNode::AddChild(std::unique_ptr<SceneNode> child) {
   child->parent_ = this;
   children_.emplace_back(std::move(child));
 }
 
+std::unique_ptr<SceneNode> SceneNode::RemoveChild(const SceneNode& child) {
+  for (auto itr = children_.begin(); itr != children_.end(); ++itr) {
+    if (itr->get() == &child) {
+      // Keeps the order of the remaining children.
+      std::unique_ptr<SceneNode> removed = std::move(*itr);
+      children_.erase(itr);
+      removed->parent_ = nullptr;
+      removed->RemoveFromSpatialIndex();
+      return removed;
+    }
+  }
+  throw std::runtime_error("Cannot remove a node that is not a child!");
+}
+
+void SceneNode::RemoveFromSpatialIndex() {
+  if (spatial_proxy_.index != nullptr) {
+    spatial_proxy_.index->Remove(spatial_proxy_.leaf);
+    spatial_proxy_ = SpatialProxy();
+  }
+  for (auto& child : children_) {
+    child->RemoveFromSpatialIndex();
+  }
+}
+
 ComponentBase* SceneNode::GetComponentPtrByType(ComponentType type) const {
-  if (IsActive() && component_dict_.count(type)) {
-    return component_dict_.at(type).get();
+  if (IsActive()) {
+    return components_[static_cast<size_t>(type)].get();
   }
   return nullptr;
 }
@@ -1,9 +1,9 @@
 #ifndef GLOO_SCENE_NODE_H_
 #define GLOO_SCENE_NODE_H_
 
+#include <array>
 #include <vector>
 #include <memory>
-#include <unordered_map>
 #include <iostream>
 #include <typeinfo>
 #include <stdexcept>
@@ -11,14 +11,27 @@
 #include <glm/vec3.hpp>
 
 #include "components/ComponentBase.hpp"
+#include "components/ComponentRegistry.hpp"
 #include "components/ComponentType.hpp"
+#include "PoolAllocator.hpp"
 #include "Transform.hpp"
 
 namespace GLOO {
+class BoundingVolumeHierarchy;
+class VertexObject;
+
 class SceneNode {
  public:
   SceneNode();
-  virtual ~SceneNode() {
+  virtual ~SceneNode();
+
+  // Nodes live in PoolAllocator blocks, so nodes removed during editing
+  // free memory that the next added nodes reuse.
+  static void* operator new(size_t size) {
+    return PoolAllocator::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    PoolAllocator::Deallocate(ptr, size);
   }
 
   size_t GetChildrenCount() const {
@@ -34,21 +47,27 @@ class SceneNode {
   }
 
   void AddChild(std::unique_ptr<SceneNode> child);
+  // Detaches child, which leaves the spatial index of its scene with all of
+  // its descendants, and returns it; dropping the result destroys it. Must
+  // not be called on a node that is being updated.
+  std::unique_ptr<SceneNode> RemoveChild(const SceneNode& child);
 
   template <class T>
   void AddComponent(std::unique_ptr<T> component) {
     component->SetNodePtr(this);
-    component_dict_[ComponentTrait<T>::GetType()] = std::move(component);
+    ComponentType type = ComponentTrait<T>::GetType();
+    ComponentRegistry::Add(type, component.get());
+    components_[static_cast<size_t>(type)] = std::move(component);
   }
 
   template <class T>
   bool RemoveComponent() {
-    auto itr = component_dict_.find(ComponentTrait<T>::GetType());
-    if (itr != component_dict_.end()) {
-      component_dict_.erase(itr);
-      return true;
-    }
-    return false;
+    std::unique_ptr<ComponentBase>& slot =
+        components_[static_cast<size_t>(ComponentTrait<T>::GetType())];
+    if (slot == nullptr)
+      return false;
+    slot.reset();
+    return true;
   }
 
   template <class T, typename... Args>
@@ -100,12 +119,24 @@ class SceneNode {
   void GatherComponentPtrsRecursivelyByType(
       ComponentType type,
       std::vector<ComponentBase*>& result) const;
+  void RemoveFromSpatialIndex();
+
+  // Leaf of this node in the spatial index of its Scene, and the state its
+  // bounds were last computed from.
+  friend class Scene;
+  struct SpatialProxy {
+    BoundingVolumeHierarchy* index{nullptr};
+    int leaf{-1};
+    const VertexObject* vertex_obj{nullptr};
+    unsigned int bounds_version{0};
+  };
 
   Transform transform_;
-  std::unordered_map<ComponentType,
-                     std::unique_ptr<ComponentBase>,
-                     EnumClassHash>
-      component_dict_;
+  SpatialProxy spatial_proxy_;
+  // Version of transform_ at the last Scene update.
+  unsigned int synced_transform_version_{0};
+  // Indexed by ComponentType.
+  std::array<std::unique_ptr<ComponentBase>, kNumComponentTypes> components_;
   std::vector<std::unique_ptr<SceneNode>> children_;
   SceneNode* parent_;
   bool active_;
@@ -13,7 +13,6 @@ Transform::Transform(SceneNode& node)
       rotation_(glm::quat(1.f, 0.f, 0.f, 0.f)),
       scale_(glm::vec3(1.f)),
       node_(node) {
-  UNUSED(node_);
   UpdateLocalTransformMatrix();
 }
 
@@ -83,8 +82,13 @@ glm::mat4 Transform::GetLocalToAncestorMatrix(SceneNode* ancestor) const {
 }
 
 glm::mat4 Transform::GetLocalToWorldMatrix() const {
-  // TODO: calculate local-to-world matrix.
-  return local_transform_mat_;
+  glm::mat4 local_to_world = local_transform_mat_;
+  for (SceneNode* ancestor = node_.GetParentPtr(); ancestor != nullptr;
+       ancestor = ancestor->GetParentPtr()) {
+    local_to_world =
+        ancestor->GetTransform().GetLocalToParentMatrix() * local_to_world;
+  }
+  return local_to_world;
 }
 
 void Transform::UpdateLocalTransformMatrix() {
@@ -96,5 +100,6 @@ void Transform::UpdateLocalTransformMatrix() {
   new_matrix = glm::translate(glm::mat4(1.f), position_) * new_matrix;
 
   local_transform_mat_ = std::move(new_matrix);
+  version_++;
 }
 }  // namespace GLOO
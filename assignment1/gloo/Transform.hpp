@@ -25,6 +25,11 @@ class Transform {
   glm::vec3 GetScale() const {
     return scale_;
   }
+  // Incremented whenever the local transform changes; the world transform
+  // also changes with that of any ancestor.
+  unsigned int GetVersion() const {
+    return version_;
+  }
   glm::vec3 GetWorldPosition() const;
   glm::mat4 GetLocalToWorldMatrix() const;
   glm::mat4 GetLocalToParentMatrix() const;
@@ -44,6 +49,7 @@ class Transform {
   glm::vec3 scale_;
 
   glm::mat4 local_transform_mat_;
+  unsigned int version_{0};
 
   SceneNode& node_;
 };
@@ -3,49 +3,315 @@
 #include <memory>
 #include <iostream>
 #include <stdexcept>
+#include <cstring>
+#include <cmath>
+
+#include <glm/gtc/packing.hpp>
 
 #include "gloo/gl_wrapper/BindGuard.hpp"
 #include "gloo/SceneNode.hpp"
 
+namespace {
+// Octahedral normal encoding, see "A Survey of Efficient Representations for
+// Independent Unit Vectors" (Cigolle et al. 2014).
+glm::vec2 EncodeOctahedral(glm::vec3 n) {
+  float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+  if (l1 == 0.0f)
+    return glm::vec2(0.0f);
+  n /= l1;
+  glm::vec2 e(n.x, n.y);
+  if (n.z < 0.0f) {
+    e = (1.0f - glm::abs(glm::vec2(n.y, n.x))) *
+        glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+  }
+  return e;
+}
+
+template <class T>
+void Write(uint8_t* dst, const T& value) {
+  std::memcpy(dst, &value, sizeof(T));
+}
+
+// Copy-assigning into an existing vector reuses its capacity.
+template <class T>
+void Retain(std::unique_ptr<std::vector<T>>& owned,
+            const std::vector<T>& source) {
+  if (owned == nullptr)
+    owned = GLOO::make_unique<std::vector<T>>(source);
+  else
+    *owned = source;
+}
+}  // namespace
+
 namespace GLOO {
 void VertexObject::UpdatePositions(std::unique_ptr<PositionArray> positions) {
-  if (positions_ == nullptr) {
-    vertex_array_->CreatePositionBuffer();
-  }
   positions_ = std::move(positions);
-  vertex_array_->UpdatePositions(*positions_);
+  has_positions_ = true;
+  num_vertices_ = positions_->size();
+  vertex_bounds_ = BoundingBox::FromPoints(*positions_);
+  UpdateBounds();
+  if (IsInterleaved()) {
+    interleaved_dirty_ = true;
+    return;
+  }
+  UploadPositions(*positions_);
+  if (!retain_cpu_data_)
+    positions_.reset();
 }
 
 void VertexObject::UpdateIndices(std::unique_ptr<IndexArray> indices) {
-  if (indices_ == nullptr) {
-    vertex_array_->CreateIndexBuffer();
-  }
   indices_ = std::move(indices);
-  vertex_array_->UpdateIndices(*indices_);
+  UploadIndices(*indices_);
+  if (!retain_cpu_data_)
+    indices_.reset();
 }
 
-void VertexObject::UpdateNormals(std::unique_ptr<NormalArray> normals) {
-  if (normals_ == nullptr) {
-    vertex_array_->CreateNormalBuffer();
+void VertexObject::UpdateInstanceOffsets(const PositionArray& offsets) {
+  if (!vertex_array_->HasInstanceOffsetBuffer()) {
+    vertex_array_->CreateInstanceOffsetBuffer();
   }
+  vertex_array_->UpdateInstanceOffsets(offsets);
+  has_instances_ = true;
+  num_instances_ = offsets.size();
+  instance_bounds_ = BoundingBox::FromPoints(offsets);
+  UpdateBounds();
+}
+
+void VertexObject::UpdateNormals(std::unique_ptr<NormalArray> normals) {
   normals_ = std::move(normals);
-  vertex_array_->UpdateNormals(*normals_);
+  has_normals_ = true;
+  if (IsInterleaved()) {
+    interleaved_dirty_ = true;
+    return;
+  }
+  UploadNormals(*normals_);
+  if (!retain_cpu_data_)
+    normals_.reset();
 }
 
 void VertexObject::UpdateColors(std::unique_ptr<ColorArray> colors) {
-  if (colors_ == nullptr) {
-    vertex_array_->CreateColorBuffer();
-  }
   colors_ = std::move(colors);
-  vertex_array_->UpdateColors(*colors_);
+  has_colors_ = true;
+  if (IsInterleaved()) {
+    interleaved_dirty_ = true;
+    return;
+  }
+  UploadColors(*colors_);
+  if (!retain_cpu_data_)
+    colors_.reset();
 }
 
 void VertexObject::UpdateTexCoord(std::unique_ptr<TexCoordArray> tex_coords) {
-  if (tex_coords_ == nullptr) {
+  tex_coords_ = std::move(tex_coords);
+  has_tex_coords_ = true;
+  if (IsInterleaved()) {
+    interleaved_dirty_ = true;
+    return;
+  }
+  UploadTexCoords(*tex_coords_);
+  if (!retain_cpu_data_)
+    tex_coords_.reset();
+}
+
+void VertexObject::Update(const PositionArray& positions,
+                          const NormalArray* normals,
+                          const IndexArray* indices,
+                          const ColorArray* colors,
+                          const TexCoordArray* tex_coords) {
+  has_positions_ = true;
+  num_vertices_ = positions.size();
+  vertex_bounds_ = BoundingBox::FromPoints(positions);
+  UpdateBounds();
+  has_normals_ |= normals != nullptr;
+  has_colors_ |= colors != nullptr;
+  has_tex_coords_ |= tex_coords != nullptr;
+
+  if (IsInterleaved()) {
+    // Attributes not passed in are packed from their retained copies.
+    interleaved_dirty_ = false;
+    Pack(&positions, normals != nullptr ? normals : normals_.get(),
+         colors != nullptr ? colors : colors_.get(),
+         tex_coords != nullptr ? tex_coords : tex_coords_.get());
+  } else {
+    UploadPositions(positions);
+    if (normals != nullptr)
+      UploadNormals(*normals);
+    if (colors != nullptr)
+      UploadColors(*colors);
+    if (tex_coords != nullptr)
+      UploadTexCoords(*tex_coords);
+  }
+  if (indices != nullptr)
+    UploadIndices(*indices);
+
+  if (retain_cpu_data_) {
+    Retain(positions_, positions);
+    if (normals != nullptr)
+      Retain(normals_, *normals);
+    if (colors != nullptr)
+      Retain(colors_, *colors);
+    if (tex_coords != nullptr)
+      Retain(tex_coords_, *tex_coords);
+    if (indices != nullptr)
+      Retain(indices_, *indices);
+  }
+}
+
+void VertexObject::SetRetainCPUData(bool retain) {
+  retain_cpu_data_ = retain;
+  // Arrays waiting to be packed are released once packed.
+  if (!retain_cpu_data_ && !interleaved_dirty_)
+    ReleaseCPUData();
+}
+
+void VertexObject::ReleaseCPUData() {
+  positions_.reset();
+  normals_.reset();
+  colors_.reset();
+  tex_coords_.reset();
+  indices_.reset();
+}
+
+void VertexObject::UpdateBounds() {
+  bounds_ = vertex_bounds_;
+  if (has_instances_) {
+    if (bounds_.IsEmpty() || instance_bounds_.IsEmpty()) {
+      bounds_ = BoundingBox();
+    } else {
+      bounds_.min += instance_bounds_.min;
+      bounds_.max += instance_bounds_.max;
+    }
+  }
+  bounds_version_++;
+}
+
+void VertexObject::UploadPositions(const PositionArray& positions) {
+  if (!vertex_array_->HasPositionBuffer()) {
+    vertex_array_->CreatePositionBuffer();
+  }
+  vertex_array_->UpdatePositions(positions);
+}
+
+void VertexObject::UploadNormals(const NormalArray& normals) {
+  if (!vertex_array_->HasNormalBuffer()) {
+    vertex_array_->CreateNormalBuffer();
+  }
+  vertex_array_->UpdateNormals(normals);
+}
+
+void VertexObject::UploadColors(const ColorArray& colors) {
+  if (!vertex_array_->HasColorBuffer()) {
+    vertex_array_->CreateColorBuffer();
+  }
+  vertex_array_->UpdateColors(colors);
+}
+
+void VertexObject::UploadTexCoords(const TexCoordArray& tex_coords) {
+  if (!vertex_array_->HasTexCoordBuffer()) {
     vertex_array_->CreateTexCoordBuffer();
   }
-  tex_coords_ = std::move(tex_coords);
-  vertex_array_->UpdateTexCoords(*tex_coords_);
+  vertex_array_->UpdateTexCoords(tex_coords);
+}
+
+void VertexObject::UploadIndices(const IndexArray& indices) {
+  if (!has_indices_) {
+    vertex_array_->CreateIndexBuffer();
+  }
+  has_indices_ = true;
+  num_indices_ = indices.size();
+  vertex_array_->UpdateIndices(indices);
+}
+
+void VertexObject::PackInterleaved() {
+  interleaved_dirty_ = false;
+  Pack(positions_.get(), normals_.get(), colors_.get(), tex_coords_.get());
+  if (!retain_cpu_data_)
+    ReleaseCPUData();
 }
 
+void VertexObject::Pack(const PositionArray* positions,
+                        const NormalArray* normals,
+                        const ColorArray* colors,
+                        const TexCoordArray* tex_coords) {
+  auto check_source = [](const void* source, bool present) {
+    if (present && source == nullptr)
+      throw std::runtime_error(
+          "Cannot repack a VertexObject whose CPU data was not retained; "
+          "pass every attribute to Update instead!");
+  };
+  check_source(positions, has_positions_);
+  check_source(normals, has_normals_);
+  check_source(colors, has_colors_);
+  check_source(tex_coords, has_tex_coords_);
+  if (positions == nullptr)
+    throw std::runtime_error(
+        "Cannot interleave a VertexObject without positions!");
+
+  size_t num_vertices = positions->size();
+  auto check_size = [num_vertices](size_t size) {
+    if (size != num_vertices)
+      throw std::runtime_error(
+          "Vertex attributes of an interleaved VertexObject differ in size!");
+  };
+  if (normals != nullptr)
+    check_size(normals->size());
+  if (colors != nullptr)
+    check_size(colors->size());
+  if (tex_coords != nullptr)
+    check_size(tex_coords->size());
+
+  VertexLayout layout =
+      VertexLayout::Create(format_, normals != nullptr, colors != nullptr,
+                           tex_coords != nullptr);
+  std::vector<uint8_t> data(layout.stride * num_vertices);
+  bool compact = format_ == VertexFormat::Compact;
+  for (size_t i = 0; i < num_vertices; i++) {
+    uint8_t* vertex = data.data() + i * layout.stride;
+    const glm::vec3& p = (*positions)[i];
+    if (compact) {
+      uint16_t half[4] = {glm::packHalf1x16(p.x), glm::packHalf1x16(p.y),
+                          glm::packHalf1x16(p.z), glm::packHalf1x16(1.0f)};
+      Write(vertex + layout.position.offset, half);
+    } else {
+      Write(vertex + layout.position.offset, p);
+    }
+
+    if (normals != nullptr) {
+      const glm::vec3& n = (*normals)[i];
+      if (compact) {
+        glm::vec2 e = EncodeOctahedral(n);
+        uint16_t snorm[2] = {glm::packSnorm1x16(e.x), glm::packSnorm1x16(e.y)};
+        Write(vertex + layout.normal.offset, snorm);
+      } else {
+        Write(vertex + layout.normal.offset, n);
+      }
+    }
+
+    if (colors != nullptr) {
+      const glm::vec4& c = (*colors)[i];
+      if (compact) {
+        uint8_t unorm[4] = {glm::packUnorm1x8(c.r), glm::packUnorm1x8(c.g),
+                            glm::packUnorm1x8(c.b), glm::packUnorm1x8(c.a)};
+        Write(vertex + layout.color.offset, unorm);
+      } else {
+        Write(vertex + layout.color.offset, c);
+      }
+    }
+
+    if (tex_coords != nullptr) {
+      const glm::vec2& uv = (*tex_coords)[i];
+      if (compact) {
+        uint16_t half[2] = {glm::packHalf1x16(uv.s), glm::packHalf1x16(uv.t)};
+        Write(vertex + layout.tex_coord.offset, half);
+      } else {
+        Write(vertex + layout.tex_coord.offset, uv);
+      }
+    }
+  }
+
+  if (!vertex_array_->HasInterleavedBuffer()) {
+    vertex_array_->CreateInterleavedBuffer();
+  }
+  vertex_array_->UpdateInterleaved(data, layout);
+}
 }  // namespace GLOO
@@ -1,6 +1,10 @@
 #ifndef GLOO_VERTEX_OBJECT_H_
 #define GLOO_VERTEX_OBJECT_H_
 
+#include <string>
+#include <stdexcept>
+
+#include "gloo/BoundingBox.hpp"
 #include "gloo/gl_wrapper/VertexArray.hpp"
 
 namespace GLOO {
@@ -8,7 +12,13 @@ namespace GLOO {
 // for sending data from CPU to GPU via the Update* methods.
 class VertexObject {
  public:
-  VertexObject() : vertex_array_(make_unique<VertexArray>()) {
+  // usage hints how often the data will be rewritten; geometry re-plotted
+  // during editing should use Dynamic or Ring instead of the default.
+  // With a packed format, positions/normals/colors/tex coords share a single
+  // interleaved VBO that is repacked lazily on the next GetVertexArray().
+  VertexObject(BufferUsage usage = BufferUsage::Static,
+               VertexFormat format = VertexFormat::Separate)
+      : vertex_array_(make_unique<VertexArray>(usage)), format_(format) {
   }
 
   // Vertex buffers are created in a lazy manner in the following Update*.
@@ -17,58 +27,99 @@ class VertexObject {
   void UpdateColors(std::unique_ptr<ColorArray> colors);
   void UpdateTexCoord(std::unique_ptr<TexCoordArray> tex_coords);
   void UpdateIndices(std::unique_ptr<IndexArray> indices);
+  // Draws a copy of the vertices translated by each offset, all in one
+  // instanced draw call. Bounds cover every copy. Offsets are not retained.
+  void UpdateInstanceOffsets(const PositionArray& offsets);
+
+  // Uploads straight from the caller's arrays, so per-frame re-plots can
+  // reuse their own storage instead of allocating new vectors. A nullptr
+  // attribute is left as it was. Retained CPU copies reuse their capacity.
+  void Update(const PositionArray& positions,
+              const NormalArray* normals = nullptr,
+              const IndexArray* indices = nullptr,
+              const ColorArray* colors = nullptr,
+              const TexCoordArray* tex_coords = nullptr);
+
+  // By default the arrays passed to Update* are kept as a CPU-side copy for
+  // the Get* accessors. GPU-only meshes can turn this off to drop them right
+  // after upload.
+  void SetRetainCPUData(bool retain);
+  bool IsRetainingCPUData() const {
+    return retain_cpu_data_;
+  }
 
   bool HasPositions() const {
-    return positions_ != nullptr;
+    return has_positions_;
   }
 
   bool HasNormals() const {
-    return normals_ != nullptr;
+    return has_normals_;
   }
 
   bool HasColors() const {
-    return colors_ != nullptr;
+    return has_colors_;
   }
 
   bool HasTexCoors() const {
-    return tex_coords_ != nullptr;
+    return has_tex_coords_;
   }
 
   bool HasIndices() const {
-    return indices_ != nullptr;
+    return has_indices_;
+  }
+
+  bool HasInstances() const {
+    return has_instances_;
+  }
+
+  // Counts stay valid when the CPU copies are not retained.
+  size_t GetVertexCount() const {
+    return num_vertices_;
+  }
+
+  size_t GetIndexCount() const {
+    return num_indices_;
+  }
+
+  size_t GetInstanceCount() const {
+    return num_instances_;
+  }
+
+  // Object-space bounds of the positions, computed whenever they are updated.
+  const BoundingBox& GetBounds() const {
+    return bounds_;
+  }
+  unsigned int GetBoundsVersion() const {
+    return bounds_version_;
   }
 
   const PositionArray& GetPositions() const {
-    if (positions_ == nullptr)
-      throw std::runtime_error("No position in VertexObject!");
-    return *positions_;
+    return GetRetained(positions_, has_positions_, "position");
   }
 
   const NormalArray& GetNormals() const {
-    if (normals_ == nullptr)
-      throw std::runtime_error("No normal in VertexObject!");
-    return *normals_;
+    return GetRetained(normals_, has_normals_, "normal");
   }
 
   const ColorArray& GetColors() const {
-    if (colors_ == nullptr)
-      throw std::runtime_error("No color in VertexObject!");
-    return *colors_;
+    return GetRetained(colors_, has_colors_, "color");
   }
 
   const TexCoordArray& GetTexCoords() const {
-    if (tex_coords_ == nullptr)
-      throw std::runtime_error("No texture coordinate in VertexObject!");
-    return *tex_coords_;
+    return GetRetained(tex_coords_, has_tex_coords_, "texture coordinate");
   }
 
   const IndexArray& GetIndices() const {
-    if (indices_ == nullptr)
-      throw std::runtime_error("No indices in VertexObject!");
-    return *indices_;
+    return GetRetained(indices_, has_indices_, "indices");
+  }
+
+  VertexFormat GetFormat() const {
+    return format_;
   }
 
   VertexArray& GetVertexArray() {
+    if (interleaved_dirty_)
+      PackInterleaved();
     return *vertex_array_.get();
   }
   const VertexArray& GetVertexArray() const {
@@ -76,7 +127,53 @@ class VertexObject {
   }
 
  private:
+  bool IsInterleaved() const {
+    return format_ != VertexFormat::Separate;
+  }
+  template <class T>
+  static const std::vector<T>& GetRetained(
+      const std::unique_ptr<std::vector<T>>& array,
+      bool present,
+      const std::string& name) {
+    if (!present)
+      throw std::runtime_error("No " + name + " in VertexObject!");
+    if (array == nullptr)
+      throw std::runtime_error("CPU copy of " + name +
+                               " was not retained in VertexObject!");
+    return *array;
+  }
+
+  void UploadPositions(const PositionArray& positions);
+  void UploadNormals(const NormalArray& normals);
+  void UploadColors(const ColorArray& colors);
+  void UploadTexCoords(const TexCoordArray& tex_coords);
+  void UploadIndices(const IndexArray& indices);
+  void PackInterleaved();
+  void Pack(const PositionArray* positions,
+            const NormalArray* normals,
+            const ColorArray* colors,
+            const TexCoordArray* tex_coords);
+  void ReleaseCPUData();
+  void UpdateBounds();
+
   std::unique_ptr<VertexArray> vertex_array_;
+  VertexFormat format_;
+  bool interleaved_dirty_{false};
+  bool retain_cpu_data_{true};
+
+  bool has_positions_{false};
+  bool has_normals_{false};
+  bool has_colors_{false};
+  bool has_tex_coords_{false};
+  bool has_indices_{false};
+  bool has_instances_{false};
+  size_t num_vertices_{0};
+  size_t num_indices_{0};
+  size_t num_instances_{0};
+  BoundingBox vertex_bounds_;
+  BoundingBox instance_bounds_;
+  BoundingBox bounds_;
+  unsigned int bounds_version_{0};
 
   // Owner of vertex data.
   std::unique_ptr<PositionArray> positions_;
@@ -1,7 +1,9 @@
 #ifndef GLOO_COMPONENT_BASE_H_
 #define GLOO_COMPONENT_BASE_H_
 
+#include "ComponentRegistry.hpp"
 #include "ComponentType.hpp"
+#include "gloo/PoolAllocator.hpp"
 
 namespace GLOO {
 class SceneNode;
@@ -9,6 +11,14 @@ class SceneNode;
 class ComponentBase {
  public:
   virtual ~ComponentBase() {
+    ComponentRegistry::Remove(this);
+  }
+  // Pooled like SceneNode.
+  static void* operator new(size_t size) {
+    return PoolAllocator::Allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) {
+    PoolAllocator::Deallocate(ptr, size);
   }
   void SetNodePtr(SceneNode* node_ptr) {
     node_ptr_ = node_ptr;
@@ -19,6 +29,12 @@ class ComponentBase {
 
  protected:
   SceneNode* node_ptr_;
+
+ private:
+  friend class ComponentRegistry;
+  // Slot in the registry's pool of registered_type_, or -1.
+  ComponentType registered_type_{ComponentType::Undefined};
+  int registry_index_{-1};
 };
 }  // namespace GLOO
 
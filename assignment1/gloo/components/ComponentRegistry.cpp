@@ -0,0 +1,42 @@
+#include "ComponentRegistry.hpp"
+
+#include "ComponentBase.hpp"
+
+namespace {
+using namespace GLOO;
+
+// Never destroyed, so that components destroyed during static destruction
+// can still unregister.
+std::vector<ComponentBase*>* GetPools() {
+  static std::vector<ComponentBase*>* pools =
+      new std::vector<ComponentBase*>[kNumComponentTypes];
+  return pools;
+}
+}  // namespace
+
+namespace GLOO {
+const std::vector<ComponentBase*>& ComponentRegistry::GetComponents(
+    ComponentType type) {
+  return GetPools()[static_cast<size_t>(type)];
+}
+
+void ComponentRegistry::Add(ComponentType type, ComponentBase* component) {
+  std::vector<ComponentBase*>& pool = GetPools()[static_cast<size_t>(type)];
+  component->registered_type_ = type;
+  component->registry_index_ = static_cast<int>(pool.size());
+  pool.push_back(component);
+}
+
+void ComponentRegistry::Remove(ComponentBase* component) {
+  if (component->registry_index_ < 0)
+    return;
+  std::vector<ComponentBase*>& pool =
+      GetPools()[static_cast<size_t>(component->registered_type_)];
+  // Fill the hole with the last component.
+  ComponentBase* last = pool.back();
+  pool[component->registry_index_] = last;
+  last->registry_index_ = component->registry_index_;
+  pool.pop_back();
+  component->registry_index_ = -1;
+}
+}  // namespace GLOO
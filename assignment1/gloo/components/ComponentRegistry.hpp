@@ -0,0 +1,32 @@
+#ifndef GLOO_COMPONENT_REGISTRY_H_
+#define GLOO_COMPONENT_REGISTRY_H_
+
+#include <vector>
+
+#include "ComponentType.hpp"
+
+namespace GLOO {
+class ComponentBase;
+
+// Every component attached to a node, packed densely per type, so that
+// all components of a type can be visited without walking scene trees.
+// Components register when added to a node and unregister when destroyed
+// or removed; the order within a type is unspecified.
+class ComponentRegistry {
+ public:
+  static const std::vector<ComponentBase*>& GetComponents(ComponentType type);
+
+  template <class T>
+  static const std::vector<ComponentBase*>& GetComponents() {
+    return GetComponents(ComponentTrait<T>::GetType());
+  }
+
+ private:
+  friend class ComponentBase;
+  friend class SceneNode;
+  static void Add(ComponentType type, ComponentBase* component);
+  static void Remove(ComponentBase* component);
+};
+}  // namespace GLOO
+
+#endif
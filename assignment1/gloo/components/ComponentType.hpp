@@ -14,8 +14,14 @@ enum class ComponentType {
   Camera,
   Light,
   Tracing,
+  LevelOfDetail,
 };
 
+// Every SceneNode has one component slot per type. Keep in sync with the
+// last type above.
+const size_t kNumComponentTypes =
+    static_cast<size_t>(ComponentType::LevelOfDetail) + 1;
+
 template <typename T>
 struct ComponentTrait {
   static ComponentType GetType() {
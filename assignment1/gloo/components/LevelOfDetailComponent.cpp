@@ -0,0 +1,68 @@
+#include "LevelOfDetailComponent.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "CameraComponent.hpp"
+#include "RenderingComponent.hpp"
+#include "gloo/SceneNode.hpp"
+
+namespace GLOO {
+void LevelOfDetailComponent::AddLevel(std::shared_ptr<VertexObject> vertex_obj,
+                                      float min_screen_size,
+                                      int start_index,
+                                      int num_indices) {
+  levels_.push_back(
+      {std::move(vertex_obj), min_screen_size, start_index, num_indices});
+}
+
+void LevelOfDetailComponent::SelectLevel(const CameraComponent& camera,
+                                         const glm::mat4& local_to_world) {
+  if (levels_.empty())
+    return;
+  auto rendering_ptr = GetNodePtr()->GetComponentPtr<RenderingComponent>();
+  if (rendering_ptr == nullptr) {
+    throw std::runtime_error(
+        "Level of detail component has no rendering component to drive!");
+  }
+
+  // The finest level has the most accurate bounds.
+  float screen_size = ComputeScreenSize(
+      levels_[0].vertex_obj->GetBounds().Transformed(local_to_world), camera);
+  size_t level = 0;
+  while (level + 1 < levels_.size() &&
+         screen_size < levels_[level].min_screen_size) {
+    level++;
+  }
+
+  if (level != selected_level_) {
+    selected_level_ = level;
+    if (level_changed_callback_)
+      level_changed_callback_(level);
+  }
+  const Level& selected = levels_[level];
+  if (rendering_ptr->GetVertexObjectPtr() != selected.vertex_obj.get())
+    rendering_ptr->SetVertexObject(selected.vertex_obj);
+  rendering_ptr->SetDrawRange(selected.start_index, selected.num_indices);
+}
+
+float LevelOfDetailComponent::ComputeScreenSize(const BoundingBox& world_bounds,
+                                                const CameraComponent& camera) {
+  if (world_bounds.IsEmpty())
+    return 0.0f;
+  glm::mat4 projection = camera.GetProjectionMatrix();
+  float radius = glm::length(world_bounds.GetExtent());
+  if (projection[3][3] == 1.0f) {
+    // Orthographic: the size does not depend on the distance.
+    return radius * projection[1][1];
+  }
+  glm::vec3 eye(glm::inverse(camera.GetViewMatrix())[3]);
+  float distance = glm::length(world_bounds.GetCenter() - eye);
+  if (distance <= radius)
+    return std::numeric_limits<float>::max();
+  // Half-angle of the cone around the sphere against that of the view.
+  return radius * projection[1][1] /
+         std::sqrt(distance * distance - radius * radius);
+}
+}  // namespace GLOO
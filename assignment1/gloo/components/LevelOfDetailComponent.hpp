@@ -0,0 +1,65 @@
+#ifndef GLOO_LEVEL_OF_DETAIL_COMPONENT_H_
+#define GLOO_LEVEL_OF_DETAIL_COMPONENT_H_
+
+#include "ComponentBase.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "gloo/BoundingBox.hpp"
+#include "gloo/VertexObject.hpp"
+
+namespace GLOO {
+class CameraComponent;
+
+// Versions of a node's mesh from finest to coarsest. Before drawing, the
+// renderer picks the finest level whose minimum screen size the node covers
+// and hands it to the node's RenderingComponent.
+class LevelOfDetailComponent : public ComponentBase {
+ public:
+  // min_screen_size is the fraction of the viewport height the node's
+  // bounding sphere must span for the level to be used. The draw range is
+  // as in RenderingComponent::SetDrawRange.
+  void AddLevel(std::shared_ptr<VertexObject> vertex_obj,
+                float min_screen_size,
+                int start_index = -1,
+                int num_indices = -1);
+  // Called before a newly selected level is drawn, e.g. to re-tessellate it.
+  void SetLevelChangedCallback(std::function<void(size_t)> callback) {
+    level_changed_callback_ = std::move(callback);
+  }
+
+  void SelectLevel(const CameraComponent& camera,
+                   const glm::mat4& local_to_world);
+  size_t GetSelectedLevel() const {
+    return selected_level_;
+  }
+  size_t GetLevelCount() const {
+    return levels_.size();
+  }
+
+  // Fraction of the viewport height spanned by the bounding sphere of
+  // world_bounds.
+  static float ComputeScreenSize(const BoundingBox& world_bounds,
+                                 const CameraComponent& camera);
+
+ private:
+  struct Level {
+    std::shared_ptr<VertexObject> vertex_obj;
+    float min_screen_size;
+    int start_index;
+    int num_indices;
+  };
+
+  std::vector<Level> levels_;
+  size_t selected_level_{0};
+  std::function<void(size_t)> level_changed_callback_;
+};
+
+CREATE_COMPONENT_TRAIT(LevelOfDetailComponent, ComponentType::LevelOfDetail);
+}  // namespace GLOO
+
+#endif
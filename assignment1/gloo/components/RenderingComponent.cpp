@@ -32,10 +32,10 @@ void RenderingComponent::Render() const {
                                          static_cast<size_t>(num_indices_));
   } else {
     if (vertex_obj_->HasIndices())
-      vertex_obj_->GetVertexArray().Render(0, vertex_obj_->GetIndices().size());
+      vertex_obj_->GetVertexArray().Render(0, vertex_obj_->GetIndexCount());
     else
       vertex_obj_->GetVertexArray().Render(0,
-                                           vertex_obj_->GetPositions().size());
+                                           vertex_obj_->GetVertexCount());
   }
 }
 
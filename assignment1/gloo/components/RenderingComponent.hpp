@@ -17,6 +17,12 @@ class RenderingComponent : public ComponentBase {
     return vertex_obj_.get();
   }
 
+  // World-space bounds of the attached vertex object. Empty when the
+  // vertex object has no positions yet.
+  BoundingBox GetWorldBounds(const glm::mat4& local_to_world) const {
+    return vertex_obj_->GetBounds().Transformed(local_to_world);
+  }
+
   void Render() const;
 
  private:
@@ -37,6 +37,7 @@ std::unique_ptr<VertexObject> PrimitiveFactory::CreateSphere(float r,
     }
 
   auto obj = make_unique<VertexObject>();
+  obj->SetRetainCPUData(false);
   obj->UpdatePositions(std::move(positions));
   obj->UpdateNormals(std::move(normals));
   obj->UpdateIndices(std::move(indices));
@@ -81,6 +82,7 @@ PrimitiveFactory::CreateCylinder(float r, float h, size_t num_sides) {
     indices->insert(indices->end(), {i1, i2, i3});
   }
   auto obj = make_unique<VertexObject>();
+  obj->SetRetainCPUData(false);
   obj->UpdatePositions(std::move(positions));
   obj->UpdateNormals(std::move(normals));
   obj->UpdateIndices(std::move(indices));
@@ -109,6 +111,7 @@ std::unique_ptr<VertexObject> PrimitiveFactory::CreateQuad() {
   tex_coords->emplace_back(0.0f, 1.0f);
 
   auto obj = make_unique<VertexObject>();
+  obj->SetRetainCPUData(false);
   obj->UpdatePositions(std::move(positions));
   obj->UpdateNormals(std::move(normals));
   obj->UpdateIndices(std::move(indices));
@@ -125,6 +128,7 @@ std::unique_ptr<VertexObject> PrimitiveFactory::CreateLineSegment(
   positions->push_back(q);
 
   auto obj = make_unique<VertexObject>();
+  obj->SetRetainCPUData(false);
   obj->UpdatePositions(std::move(positions));
   return obj;
 }
@@ -0,0 +1,27 @@
+#include "BufferStorage.hpp"
+
+#include <stdexcept>
+
+namespace GLOO {
+namespace {
+BufferStorageProc buffer_storage_proc = nullptr;
+}  // namespace
+
+void LoadBufferStorage(BufferStorageProc proc) {
+  buffer_storage_proc = proc;
+}
+
+bool HasBufferStorage() {
+  return buffer_storage_proc != nullptr;
+}
+
+void BufferStorage(GLenum target,
+                   GLsizeiptr size,
+                   const void* data,
+                   GLbitfield flags) {
+  if (buffer_storage_proc == nullptr) {
+    throw std::runtime_error("ARB_buffer_storage is not loaded!");
+  }
+  buffer_storage_proc(target, size, data, flags);
+}
+}  // namespace GLOO
@@ -0,0 +1,34 @@
+#ifndef GLOO_BUFFER_STORAGE_H_
+#define GLOO_BUFFER_STORAGE_H_
+
+#include <glad/glad.h>
+
+namespace GLOO {
+// Our GLAD loader is generated for core 3.3 without extensions, so
+// ARB_buffer_storage (core in 4.4) has to be resolved by hand. The application
+// calls LoadBufferStorage once after the context is created; buffers fall back
+// to unsynchronized glMapBufferRange when the entry point is unavailable.
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+
+typedef void(APIENTRYP BufferStorageProc)(GLenum target,
+                                          GLsizeiptr size,
+                                          const void* data,
+                                          GLbitfield flags);
+
+void LoadBufferStorage(BufferStorageProc proc);
+bool HasBufferStorage();
+void BufferStorage(GLenum target,
+                   GLsizeiptr size,
+                   const void* data,
+                   GLbitfield flags);
+}  // namespace GLOO
+
+#endif
@@ -1,8 +1,10 @@
 #include "Framebuffer.hpp"
 
 #include <stdexcept>
+#include <vector>
 
 #include "BindGuard.hpp"
+#include "gloo/Image.hpp"
 #include "gloo/utils.hpp"
 
 namespace GLOO {
@@ -11,18 +13,29 @@ Framebuffer::Framebuffer() {
 }
 
 Framebuffer::~Framebuffer() {
+  ReleaseAttachments();
   if (handle_ != GLuint(-1))
     GL_CHECK(glDeleteFramebuffers(1, &handle_));
 }
 
 Framebuffer::Framebuffer(Framebuffer&& other) noexcept {
   handle_ = other.handle_;
+  color_renderbuffer_ = other.color_renderbuffer_;
+  depth_renderbuffer_ = other.depth_renderbuffer_;
+  size_ = other.size_;
   other.handle_ = GLuint(-1);
+  other.color_renderbuffer_ = 0;
+  other.depth_renderbuffer_ = 0;
 }
 
 Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept {
   handle_ = other.handle_;
+  color_renderbuffer_ = other.color_renderbuffer_;
+  depth_renderbuffer_ = other.depth_renderbuffer_;
+  size_ = other.size_;
   other.handle_ = GLuint(-1);
+  other.color_renderbuffer_ = 0;
+  other.depth_renderbuffer_ = 0;
   return *this;
 }
 
@@ -34,6 +47,55 @@ void Framebuffer::Unbind() const {
   GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
 }
 
+void Framebuffer::AllocateAttachments(glm::ivec2 size) {
+  ReleaseAttachments();
+  size_ = size;
+
+  GL_CHECK(glGenRenderbuffers(1, &color_renderbuffer_));
+  GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer_));
+  GL_CHECK(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size.x, size.y));
+  GL_CHECK(glGenRenderbuffers(1, &depth_renderbuffer_));
+  GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer_));
+  GL_CHECK(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size.x,
+                                 size.y));
+  GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+  BindGuard bg(this);
+  GL_CHECK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                     GL_RENDERBUFFER, color_renderbuffer_));
+  GL_CHECK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                     GL_RENDERBUFFER, depth_renderbuffer_));
+  GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    throw std::runtime_error("Framebuffer is incomplete!");
+  }
+}
+
+std::unique_ptr<Image> Framebuffer::ReadColor() const {
+  if (color_renderbuffer_ == 0) {
+    throw std::runtime_error("Framebuffer has no color attachment to read!");
+  }
+  std::vector<uint8_t> pixels(3 * size_.x * size_.y);
+  {
+    BindGuard bg(this);
+    GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GL_CHECK(glReadBuffer(GL_COLOR_ATTACHMENT0));
+    GL_CHECK(glReadPixels(0, 0, size_.x, size_.y, GL_RGB, GL_UNSIGNED_BYTE,
+                          pixels.data()));
+  }
+
+  return Image::FromByteData(size_.x, size_.y, pixels.data());
+}
+
+void Framebuffer::ReleaseAttachments() {
+  if (color_renderbuffer_ != 0)
+    GL_CHECK(glDeleteRenderbuffers(1, &color_renderbuffer_));
+  if (depth_renderbuffer_ != 0)
+    GL_CHECK(glDeleteRenderbuffers(1, &depth_renderbuffer_));
+  color_renderbuffer_ = 0;
+  depth_renderbuffer_ = 0;
+}
+
 
 static_assert(std::is_move_constructible<Framebuffer>(), "");
 static_assert(std::is_move_assignable<Framebuffer>(), "");
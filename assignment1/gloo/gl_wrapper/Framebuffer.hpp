@@ -1,10 +1,14 @@
 #ifndef GLOO_FRAMEBUFFER_H_
 #define GLOO_FRAMEBUFFER_H_
 
+#include <memory>
+
 #include "BindGuard.hpp"
 #include "gloo/external.hpp"
 
 namespace GLOO {
+class Image;
+
 class Framebuffer : public IBindable {
  public:
   Framebuffer();
@@ -20,8 +24,24 @@ class Framebuffer : public IBindable {
   void Bind() const override;
   void Unbind() const override;
 
+  // (Re)creates RGBA8 color and 24-bit depth renderbuffer attachments, so
+  // the framebuffer can be rendered into offscreen.
+  void AllocateAttachments(glm::ivec2 size);
+  glm::ivec2 GetSize() const {
+    return size_;
+  }
+
+  // Reads the color attachment back with glReadPixels. Row 0 of the image is
+  // the bottom row, as in Image::LoadPNG(filename, true).
+  std::unique_ptr<Image> ReadColor() const;
+
  private:
+  void ReleaseAttachments();
+
   GLuint handle_{GLuint(-1)};
+  GLuint color_renderbuffer_{0};
+  GLuint depth_renderbuffer_{0};
+  glm::ivec2 size_{0};
 };
 }  // namespace GLOO
 
@@ -1,13 +1,19 @@
 #include "VertexArray.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "BindGuard.hpp"
 #include "gloo/utils.hpp"
 
 namespace GLOO {
-VertexArray::VertexArray()
-    : draw_mode_(DrawMode::Triangles), polygon_mode_(PolygonMode::Fill) {
+const unsigned int VertexArray::kRestartIndex;
+
+VertexArray::VertexArray(BufferUsage usage)
+    : usage_(usage),
+      draw_mode_(DrawMode::Triangles),
+      polygon_mode_(PolygonMode::Fill) {
   GL_CHECK(glGenVertexArrays(1, &handle_));
 }
 
@@ -25,6 +31,12 @@ VertexArray::VertexArray(VertexArray&& other) noexcept {
   color_buf_ = std::move(other.color_buf_);
   tex_coord_buf_ = std::move(other.tex_coord_buf_);
   idx_buf_ = std::move(other.idx_buf_);
+  interleaved_buf_ = std::move(other.interleaved_buf_);
+  instance_buf_ = std::move(other.instance_buf_);
+  layout_ = other.layout_;
+  index_type_ = other.index_type_;
+  num_indices_ = other.num_indices_;
+  usage_ = other.usage_;
   draw_mode_ = other.draw_mode_;
   polygon_mode_ = other.polygon_mode_;
 }
@@ -38,6 +50,12 @@ VertexArray& VertexArray::operator=(VertexArray&& other) noexcept {
   color_buf_ = std::move(other.color_buf_);
   tex_coord_buf_ = std::move(other.tex_coord_buf_);
   idx_buf_ = std::move(other.idx_buf_);
+  interleaved_buf_ = std::move(other.interleaved_buf_);
+  instance_buf_ = std::move(other.instance_buf_);
+  layout_ = other.layout_;
+  index_type_ = other.index_type_;
+  num_indices_ = other.num_indices_;
+  usage_ = other.usage_;
   draw_mode_ = other.draw_mode_;
   polygon_mode_ = other.polygon_mode_;
   return *this;
@@ -52,28 +70,40 @@ void VertexArray::Unbind() const {
 }
 
 void VertexArray::CreatePositionBuffer() {
-  pos_buf_ = make_unique<PositionBuffer>(GL_STATIC_DRAW);
+  pos_buf_ = make_unique<PositionBuffer>(usage_);
 }
 
 void VertexArray::CreateNormalBuffer() {
-  normal_buf_ = make_unique<NormalBuffer>(GL_STATIC_DRAW);
+  normal_buf_ = make_unique<NormalBuffer>(usage_);
 }
 
 void VertexArray::CreateColorBuffer() {
-  color_buf_ = make_unique<ColorBuffer>(GL_STATIC_DRAW);
+  color_buf_ = make_unique<ColorBuffer>(usage_);
 }
 
 void VertexArray::CreateTexCoordBuffer() {
-  tex_coord_buf_ = make_unique<TexCoordBuffer>(GL_STATIC_DRAW);
+  tex_coord_buf_ = make_unique<TexCoordBuffer>(usage_);
 }
 
 void VertexArray::CreateIndexBuffer() {
-  idx_buf_ = make_unique<IndexBuffer>(GL_STATIC_DRAW);
+  // The EBO handle is captured by the VAO, so index buffers cannot hop
+  // between ring regions; they are rewritten in place instead.
+  BufferUsage idx_usage =
+      usage_ == BufferUsage::Ring ? BufferUsage::Stream : usage_;
+  idx_buf_ = make_unique<IndexBuffer>(idx_usage);
   BindGuard vao_bg(this);
   // Different from other types of vertex buffers, EBOs should not be unbounded.
   idx_buf_->Bind();
 }
 
+void VertexArray::CreateInterleavedBuffer() {
+  interleaved_buf_ = make_unique<InterleavedBuffer>(usage_);
+}
+
+void VertexArray::CreateInstanceOffsetBuffer() {
+  instance_buf_ = make_unique<InstanceOffsetBuffer>(usage_);
+}
+
 void VertexArray::UpdatePositions(const PositionArray& positions) const {
   pos_buf_->Update(positions);
 }
@@ -90,42 +120,120 @@ void VertexArray::UpdateTexCoords(const TexCoordArray& tex_coords) const {
   tex_coord_buf_->Update(tex_coords);
 }
 
-void VertexArray::UpdateIndices(const IndexArray& indices) const {
-  idx_buf_->Update(indices);
+void VertexArray::UpdateInstanceOffsets(const PositionArray& offsets) const {
+  instance_buf_->Update(offsets);
+}
+
+void VertexArray::UpdateIndices(const IndexArray& indices) {
+  num_indices_ = indices.size();
+  // Narrowing costs a pass over the indices, which only pays off for data
+  // that is uploaded once and drawn many times.
+  if (usage_ == BufferUsage::Static) {
+    unsigned int max_index = 0;
+    for (unsigned int i : indices) {
+      if (i != kRestartIndex)
+        max_index = std::max(max_index, i);
+    }
+    if (max_index < std::numeric_limits<uint16_t>::max()) {
+      // The restart index narrows to the 16-bit restart index.
+      std::vector<uint16_t> short_indices(indices.begin(), indices.end());
+      index_type_ = GL_UNSIGNED_SHORT;
+      idx_buf_->Update(reinterpret_cast<const uint8_t*>(short_indices.data()),
+                       sizeof(uint16_t) * short_indices.size());
+      return;
+    }
+  }
+  index_type_ = GL_UNSIGNED_INT;
+  idx_buf_->Update(reinterpret_cast<const uint8_t*>(indices.data()),
+                   sizeof(unsigned int) * indices.size());
+}
+
+void VertexArray::UpdateInterleaved(const std::vector<uint8_t>& data,
+                                    const VertexLayout& layout) {
+  layout_ = layout;
+  interleaved_buf_->Update(data);
+}
+
+void VertexArray::LinkInterleavedAttribute(
+    GLuint attr_idx,
+    const VertexAttribute& attribute) const {
+  BindGuard vao_bg(this);
+  BindGuard buf_bg(interleaved_buf_.get());
+  GL_CHECK(glVertexAttribPointer(
+      attr_idx, attribute.size, attribute.type, attribute.normalized,
+      static_cast<GLsizei>(layout_.stride),
+      reinterpret_cast<void*>(interleaved_buf_->GetOffset() +
+                              attribute.offset)));
+  GL_CHECK(glEnableVertexAttribArray(attr_idx));
 }
 
 void VertexArray::LinkPositionBuffer(GLuint attr_idx) const {
+  if (interleaved_buf_ != nullptr) {
+    LinkInterleavedAttribute(attr_idx, layout_.position);
+    return;
+  }
   BindGuard vao_bg(this);
   BindGuard buf_bg(pos_buf_.get());
   // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 3, GL_FLOAT, GL_FALSE, 0, 0));
+  GL_CHECK(glVertexAttribPointer(
+      attr_idx, 3, GL_FLOAT, GL_FALSE, 0,
+      reinterpret_cast<void*>(pos_buf_->GetOffset())));
   GL_CHECK(glEnableVertexAttribArray(attr_idx));
 }
 
 void VertexArray::LinkNormalBuffer(GLuint attr_idx) const {
+  if (interleaved_buf_ != nullptr) {
+    LinkInterleavedAttribute(attr_idx, layout_.normal);
+    return;
+  }
   BindGuard vao_bg(this);
   BindGuard buf_bg(normal_buf_.get());
   // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 3, GL_FLOAT, GL_FALSE, 0, 0));
+  GL_CHECK(glVertexAttribPointer(
+      attr_idx, 3, GL_FLOAT, GL_FALSE, 0,
+      reinterpret_cast<void*>(normal_buf_->GetOffset())));
   GL_CHECK(glEnableVertexAttribArray(attr_idx));
 }
 
 void VertexArray::LinkColorBuffer(GLuint attr_idx) const {
+  if (interleaved_buf_ != nullptr) {
+    LinkInterleavedAttribute(attr_idx, layout_.color);
+    return;
+  }
   BindGuard vao_bg(this);
   BindGuard buf_bg(color_buf_.get());
   // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 4, GL_FLOAT, GL_FALSE, 0, 0));
+  GL_CHECK(glVertexAttribPointer(
+      attr_idx, 4, GL_FLOAT, GL_FALSE, 0,
+      reinterpret_cast<void*>(color_buf_->GetOffset())));
   GL_CHECK(glEnableVertexAttribArray(attr_idx));
 }
 
 void VertexArray::LinkTexCoordBuffer(GLuint attr_idx) const {
+  if (interleaved_buf_ != nullptr) {
+    LinkInterleavedAttribute(attr_idx, layout_.tex_coord);
+    return;
+  }
   BindGuard vao_bg(this);
   BindGuard buf_bg(tex_coord_buf_.get());
   // The line below attaches the vertex buffer to the VAO.
-  GL_CHECK(glVertexAttribPointer(attr_idx, 2, GL_FLOAT, GL_FALSE, 0, 0));
+  GL_CHECK(glVertexAttribPointer(
+      attr_idx, 2, GL_FLOAT, GL_FALSE, 0,
+      reinterpret_cast<void*>(tex_coord_buf_->GetOffset())));
   GL_CHECK(glEnableVertexAttribArray(attr_idx));
 }
 
+void VertexArray::LinkInstanceOffsetBuffer(GLuint attr_idx) const {
+  BindGuard vao_bg(this);
+  BindGuard buf_bg(instance_buf_.get());
+  GL_CHECK(glVertexAttribPointer(
+      attr_idx, 3, GL_FLOAT, GL_FALSE, 0,
+      reinterpret_cast<void*>(instance_buf_->GetOffset())));
+  GL_CHECK(glEnableVertexAttribArray(attr_idx));
+  // Advance once per instance instead of once per vertex.
+  GL_CHECK(glVertexAttribDivisor(attr_idx, 1));
+}
+
 void VertexArray::SetDrawMode(DrawMode mode) {
   draw_mode_ = mode;
 }
@@ -146,20 +254,52 @@ void VertexArray::Render(size_t start_index, size_t num_indices) const {
     GL_CHECK(glPolygonMode(GL_FRONT_AND_BACK, GL_FILL));
   }
 
-  GLint draw_mode = draw_mode_ == DrawMode::Triangles ? GL_TRIANGLES : GL_LINES;
+  if (instance_buf_ != nullptr && instance_buf_->GetSize() == 0)
+    return;
+
+  GLint draw_mode = GL_TRIANGLES;
+  if (draw_mode_ == DrawMode::Lines) {
+    draw_mode = GL_LINES;
+  } else if (draw_mode_ == DrawMode::LineStrip) {
+    draw_mode = GL_LINE_STRIP;
+    GL_CHECK(glEnable(GL_PRIMITIVE_RESTART));
+    GL_CHECK(glPrimitiveRestartIndex(index_type_ == GL_UNSIGNED_SHORT
+                                         ? std::numeric_limits<uint16_t>::max()
+                                         : kRestartIndex));
+  }
 
-  if (idx_buf_ != nullptr) {
+  if (instance_buf_ != nullptr) {
+    GLsizei num_instances = static_cast<GLsizei>(instance_buf_->GetSize());
+    if (idx_buf_ != nullptr) {
+      size_t index_size = index_type_ == GL_UNSIGNED_SHORT
+                              ? sizeof(uint16_t)
+                              : sizeof(unsigned int);
+      GL_CHECK(glDrawElementsInstanced(
+          draw_mode, static_cast<GLsizei>(num_indices), index_type_,
+          reinterpret_cast<void*>(start_index * index_size), num_instances));
+    } else {
+      GL_CHECK(glDrawArraysInstanced(draw_mode, (GLint)start_index,
+                                     (GLsizei)num_indices, num_instances));
+    }
+  } else if (idx_buf_ != nullptr) {
+    size_t index_size = index_type_ == GL_UNSIGNED_SHORT ? sizeof(uint16_t)
+                                                         : sizeof(unsigned int);
     GL_CHECK(glDrawElements(
-        draw_mode, static_cast<GLsizei>(num_indices), GL_UNSIGNED_INT,
-        reinterpret_cast<void*>(start_index * sizeof(unsigned int))));
+        draw_mode, static_cast<GLsizei>(num_indices), index_type_,
+        reinterpret_cast<void*>(start_index * index_size)));
   } else {
     GL_CHECK(glDrawArrays(draw_mode, (GLint)start_index, (GLsizei)num_indices));
   }
+  // Other index buffers may use the restart index as an ordinary index.
+  if (draw_mode_ == DrawMode::LineStrip)
+    GL_CHECK(glDisable(GL_PRIMITIVE_RESTART));
 }
 
 void VertexArray::Render() const {
   if (idx_buf_ != nullptr)
-    Render(0, idx_buf_->GetSize());
+    Render(0, num_indices_);
+  else if (interleaved_buf_ != nullptr && layout_.stride > 0)
+    Render(0, interleaved_buf_->GetSize() / layout_.stride);
   else {
     if (pos_buf_ == nullptr)
       throw std::runtime_error("Cannot render VertexArray without positions!");
@@ -6,15 +6,20 @@
 #include "gloo/external.hpp"
 #include "gloo/alias_types.hpp"
 #include "VertexBuffer.hpp"
+#include "VertexLayout.hpp"
 
 namespace GLOO {
-enum class DrawMode { Triangles, Lines };
+// Index arrays of line strips may hold VertexArray::kRestartIndex to start a
+// new strip.
+enum class DrawMode { Triangles, Lines, LineStrip };
 
 enum class PolygonMode { Wireframe, Fill };
 
 class VertexArray : public IBindable {
  public:
-  VertexArray();
+  static const unsigned int kRestartIndex = 0xFFFFFFFF;
+
+  VertexArray(BufferUsage usage = BufferUsage::Static);
   ~VertexArray();
 
   VertexArray(const VertexArray&) = delete;
@@ -32,55 +37,97 @@ class VertexArray : public IBindable {
   void CreateColorBuffer();
   void CreateTexCoordBuffer();
   void CreateIndexBuffer();
+  void CreateInterleavedBuffer();
+  void CreateInstanceOffsetBuffer();
   void UpdatePositions(const PositionArray& positions) const;
   void UpdateNormals(const NormalArray& normals) const;
   void UpdateColors(const ColorArray& colors) const;
   void UpdateTexCoords(const TexCoordArray& tex_coords) const;
-  void UpdateIndices(const IndexArray& indices) const;
+  // Static index data that fits is stored as 16-bit indices.
+  void UpdateIndices(const IndexArray& indices);
+  // data holds whole vertices packed as described by layout.
+  void UpdateInterleaved(const std::vector<uint8_t>& data,
+                         const VertexLayout& layout);
+  // One offset per instance. Once set, every draw is instanced, drawing
+  // nothing while there are no offsets.
+  void UpdateInstanceOffsets(const PositionArray& offsets) const;
   void LinkPositionBuffer(GLuint attr_idx) const;
   void LinkNormalBuffer(GLuint attr_idx) const;
   void LinkColorBuffer(GLuint attr_idx) const;
   void LinkTexCoordBuffer(GLuint attr_idx) const;
+  void LinkInstanceOffsetBuffer(GLuint attr_idx) const;
 
   bool HasPositionBuffer() const {
-    return pos_buf_ != nullptr;
+    return pos_buf_ != nullptr || HasInterleaved(layout_.position);
   }
 
   bool HasNormalBuffer() const {
-    return normal_buf_ != nullptr;
+    return normal_buf_ != nullptr || HasInterleaved(layout_.normal);
   }
 
   bool HasColorBuffer() const {
-    return color_buf_ != nullptr;
+    return color_buf_ != nullptr || HasInterleaved(layout_.color);
   }
 
   bool HasTexCoordBuffer() const {
-    return tex_coord_buf_ != nullptr;
+    return tex_coord_buf_ != nullptr || HasInterleaved(layout_.tex_coord);
   }
 
   bool HasIndexBuffer() const {
     return idx_buf_ != nullptr;
   }
 
+  // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+  GLenum GetIndexType() const {
+    return index_type_;
+  }
+
+  bool HasInterleavedBuffer() const {
+    return interleaved_buf_ != nullptr;
+  }
+
+  bool HasInstanceOffsetBuffer() const {
+    return instance_buf_ != nullptr;
+  }
+
+  bool HasOctahedralNormals() const {
+    return interleaved_buf_ != nullptr && layout_.octahedral_normals;
+  }
+
   void SetDrawMode(DrawMode mode);
   void SetPolygonMode(PolygonMode mode);
   void Render(size_t start_index, size_t num_indices) const;
   void Render() const;
 
  private:
+  bool HasInterleaved(const VertexAttribute& attribute) const {
+    return interleaved_buf_ != nullptr && attribute.IsPresent();
+  }
+  void LinkInterleavedAttribute(GLuint attr_idx,
+                                const VertexAttribute& attribute) const;
+
   // Buffers are invisible to the outside.
   using PositionBuffer = VertexBuffer<glm::vec3, GL_ARRAY_BUFFER>;
   using NormalBuffer = VertexBuffer<glm::vec3, GL_ARRAY_BUFFER>;
   using ColorBuffer = VertexBuffer<glm::vec4, GL_ARRAY_BUFFER>;
   using TexCoordBuffer = VertexBuffer<glm::vec2, GL_ARRAY_BUFFER>;
-  using IndexBuffer = VertexBuffer<unsigned int, GL_ELEMENT_ARRAY_BUFFER>;
+  // Raw bytes, since the index type can change between updates.
+  using IndexBuffer = VertexBuffer<uint8_t, GL_ELEMENT_ARRAY_BUFFER>;
+  using InterleavedBuffer = VertexBuffer<uint8_t, GL_ARRAY_BUFFER>;
+  using InstanceOffsetBuffer = VertexBuffer<glm::vec3, GL_ARRAY_BUFFER>;
 
   std::unique_ptr<PositionBuffer> pos_buf_;
   std::unique_ptr<NormalBuffer> normal_buf_;
   std::unique_ptr<ColorBuffer> color_buf_;
   std::unique_ptr<TexCoordBuffer> tex_coord_buf_;
   std::unique_ptr<IndexBuffer> idx_buf_;
+  std::unique_ptr<InterleavedBuffer> interleaved_buf_;
+  std::unique_ptr<InstanceOffsetBuffer> instance_buf_;
+  VertexLayout layout_;
+  GLenum index_type_{GL_UNSIGNED_INT};
+  size_t num_indices_{0};
 
+  BufferUsage usage_;
   DrawMode draw_mode_;
   PolygonMode polygon_mode_;
   GLuint handle_{GLuint(-1)};
@@ -3,39 +3,186 @@
 
 #include "BindableBuffer.hpp"
 
+#include <cstring>
 #include <vector>
 
 #include <glad/glad.h>
 
 #include "BindGuard.hpp"
+#include "BufferStorage.hpp"
 #include "gloo/utils.hpp"
 
 namespace GLOO {
+// How often the contents of a buffer are rewritten.
+//   Static:  uploaded once, e.g. loaded meshes and primitives.
+//   Dynamic: rewritten now and then, e.g. on user edits.
+//   Stream:  rewritten every frame; old storage is orphaned on each update.
+//   Ring:    rewritten every frame into a triple-buffered ring guarded by
+//            fences, so updates never wait on draws still reading old data.
+enum class BufferUsage { Static, Dynamic, Stream, Ring };
+
+inline GLenum ToGLUsage(BufferUsage usage) {
+  switch (usage) {
+    case BufferUsage::Static:
+      return GL_STATIC_DRAW;
+    case BufferUsage::Dynamic:
+      return GL_DYNAMIC_DRAW;
+    default:
+      return GL_STREAM_DRAW;
+  }
+}
+
 template <class T, GLenum target>
 class VertexBuffer : public BindableBuffer {
  public:
-  VertexBuffer(GLenum usage);
-  void Update(const std::vector<T>& array);
+  VertexBuffer(BufferUsage usage);
+  ~VertexBuffer();
+  void Update(const std::vector<T>& array) {
+    Update(array.data(), array.size());
+  }
+  void Update(const T* data, size_t count);
   size_t GetSize() const {
     return size_;
   }
+  // Byte offset of the current contents inside the buffer object. Only ring
+  // buffers have a non-zero offset.
+  size_t GetOffset() const {
+    return ring_index_ * capacity_ * sizeof(T);
+  }
 
  private:
-  size_t size_;
-  GLenum usage_;
+  static const int kRingSize = 3;
+  static const GLuint64 kFenceTimeout = 1000000;  // 1ms in nanoseconds.
+
+  void UpdateRing(const T* data, size_t count);
+  void AllocateRing(size_t capacity);
+  void AdvanceRing();
+  void ReleaseRing();
+
+  size_t size_{0};
+  BufferUsage usage_;
+
+  // Ring state. capacity_ counts elements per ring region.
+  size_t capacity_{0};
+  int ring_index_{0};
+  GLsync fences_[kRingSize] = {};
+  void* mapped_{nullptr};
 };
 
 template <class T, GLenum target>
-VertexBuffer<T, target>::VertexBuffer(GLenum usage)
+VertexBuffer<T, target>::VertexBuffer(BufferUsage usage)
     : BindableBuffer(target), usage_(usage) {
 }
 
 template <class T, GLenum target>
-void VertexBuffer<T, target>::Update(const std::vector<T>& array) {
+VertexBuffer<T, target>::~VertexBuffer() {
+  ReleaseRing();
+}
+
+template <class T, GLenum target>
+void VertexBuffer<T, target>::Update(const T* data, size_t count) {
+  if (usage_ == BufferUsage::Ring) {
+    UpdateRing(data, count);
+    return;
+  }
+
   BindGuard bg(this);
-  GL_CHECK(
-      glBufferData(target_, sizeof(T) * array.size(), array.data(), usage_));
-  size_ = array.size();
+  GLsizeiptr bytes = sizeof(T) * count;
+  if (count == size_ && size_ > 0) {
+    // Same size: overwrite in place instead of reallocating storage.
+    if (usage_ == BufferUsage::Stream) {
+      GL_CHECK(glBufferData(target_, bytes, nullptr, GL_STREAM_DRAW));
+    }
+    GL_CHECK(glBufferSubData(target_, 0, bytes, data));
+  } else {
+    GL_CHECK(glBufferData(target_, bytes, data, ToGLUsage(usage_)));
+  }
+  size_ = count;
+}
+
+template <class T, GLenum target>
+void VertexBuffer<T, target>::UpdateRing(const T* data, size_t count) {
+  if (count > capacity_) {
+    AllocateRing(count);
+  } else {
+    AdvanceRing();
+  }
+
+  size_t bytes = sizeof(T) * count;
+  if (bytes > 0) {
+    if (mapped_ != nullptr) {
+      // Persistent coherent mapping: a plain copy is visible to later draws.
+      std::memcpy(static_cast<char*>(mapped_) + GetOffset(), data, bytes);
+    } else {
+      BindGuard bg(this);
+      void* ptr = glMapBufferRange(target_, GetOffset(), bytes,
+                                   GL_MAP_WRITE_BIT |
+                                       GL_MAP_INVALIDATE_RANGE_BIT |
+                                       GL_MAP_UNSYNCHRONIZED_BIT);
+      GL_CHECK_ERROR();
+      std::memcpy(ptr, data, bytes);
+      GL_CHECK(glUnmapBuffer(target_));
+    }
+  }
+  size_ = count;
+}
+
+template <class T, GLenum target>
+void VertexBuffer<T, target>::AllocateRing(size_t capacity) {
+  ReleaseRing();
+  capacity_ = capacity;
+  ring_index_ = 0;
+
+  GLsizeiptr total = kRingSize * capacity_ * sizeof(T);
+  if (HasBufferStorage()) {
+    // Immutable storage cannot be resized, so start over with a new object.
+    GLuint handle;
+    GL_CHECK(glGenBuffers(1, &handle));
+    Reset(handle);
+
+    BindGuard bg(this);
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    BufferStorage(target_, total, nullptr, flags);
+    mapped_ = glMapBufferRange(target_, 0, total, flags);
+    GL_CHECK_ERROR();
+  } else {
+    BindGuard bg(this);
+    GL_CHECK(glBufferData(target_, total, nullptr, GL_STREAM_DRAW));
+  }
+}
+
+template <class T, GLenum target>
+void VertexBuffer<T, target>::AdvanceRing() {
+  // Draws issued so far are the only readers of the current region.
+  fences_[ring_index_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  GL_CHECK_ERROR();
+  ring_index_ = (ring_index_ + 1) % kRingSize;
+
+  GLsync& fence = fences_[ring_index_];
+  if (fence == nullptr)
+    return;
+  GLenum result = glClientWaitSync(fence, 0, 0);
+  while (result == GL_TIMEOUT_EXPIRED) {
+    result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeout);
+  }
+  GL_CHECK(glDeleteSync(fence));
+  fence = nullptr;
+}
+
+template <class T, GLenum target>
+void VertexBuffer<T, target>::ReleaseRing() {
+  for (GLsync& fence : fences_) {
+    if (fence != nullptr) {
+      GL_CHECK(glDeleteSync(fence));
+      fence = nullptr;
+    }
+  }
+  if (mapped_ != nullptr) {
+    BindGuard bg(this);
+    GL_CHECK(glUnmapBuffer(target_));
+    mapped_ = nullptr;
+  }
 }
 }  // namespace GLOO
 
@@ -0,0 +1,50 @@
+#include "VertexLayout.hpp"
+
+#include <stdexcept>
+
+namespace GLOO {
+namespace {
+void Append(VertexAttribute& attribute,
+            GLint size,
+            GLenum type,
+            GLboolean normalized,
+            size_t bytes,
+            size_t& stride) {
+  attribute.size = size;
+  attribute.type = type;
+  attribute.normalized = normalized;
+  attribute.offset = stride;
+  stride += bytes;
+}
+}  // namespace
+
+VertexLayout VertexLayout::Create(VertexFormat format,
+                                  bool has_normals,
+                                  bool has_colors,
+                                  bool has_tex_coords) {
+  VertexLayout layout;
+  if (format == VertexFormat::Interleaved) {
+    Append(layout.position, 3, GL_FLOAT, GL_FALSE, 12, layout.stride);
+    if (has_normals)
+      Append(layout.normal, 3, GL_FLOAT, GL_FALSE, 12, layout.stride);
+    if (has_colors)
+      Append(layout.color, 4, GL_FLOAT, GL_FALSE, 16, layout.stride);
+    if (has_tex_coords)
+      Append(layout.tex_coord, 2, GL_FLOAT, GL_FALSE, 8, layout.stride);
+  } else if (format == VertexFormat::Compact) {
+    // Positions take 8 bytes so that every attribute stays 4-byte aligned.
+    Append(layout.position, 3, GL_HALF_FLOAT, GL_FALSE, 8, layout.stride);
+    if (has_normals) {
+      Append(layout.normal, 2, GL_SHORT, GL_TRUE, 4, layout.stride);
+      layout.octahedral_normals = true;
+    }
+    if (has_colors)
+      Append(layout.color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4, layout.stride);
+    if (has_tex_coords)
+      Append(layout.tex_coord, 2, GL_HALF_FLOAT, GL_FALSE, 4, layout.stride);
+  } else {
+    throw std::runtime_error("Separate vertex format has no packed layout!");
+  }
+  return layout;
+}
+}  // namespace GLOO
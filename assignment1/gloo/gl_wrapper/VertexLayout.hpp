@@ -0,0 +1,44 @@
+#ifndef GLOO_VERTEX_LAYOUT_H_
+#define GLOO_VERTEX_LAYOUT_H_
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+namespace GLOO {
+// How a VertexObject stores its per-vertex attributes on the GPU.
+//   Separate:    one tightly packed float VBO per attribute.
+//   Interleaved: one VBO with float attributes packed per vertex.
+//   Compact:     like Interleaved, with half-float positions and tex coords,
+//                octahedral-encoded normals and 8-bit colors.
+enum class VertexFormat { Separate, Interleaved, Compact };
+
+struct VertexAttribute {
+  // Number of components; 0 when the attribute is absent.
+  GLint size{0};
+  GLenum type{GL_FLOAT};
+  GLboolean normalized{GL_FALSE};
+  size_t offset{0};
+
+  bool IsPresent() const {
+    return size > 0;
+  }
+};
+
+struct VertexLayout {
+  VertexAttribute position;
+  VertexAttribute normal;
+  VertexAttribute color;
+  VertexAttribute tex_coord;
+  size_t stride{0};
+  // Normals are two snorm components to be decoded in the vertex shader.
+  bool octahedral_normals{false};
+
+  static VertexLayout Create(VertexFormat format,
+                             bool has_normals,
+                             bool has_colors,
+                             bool has_tex_coords);
+};
+}  // namespace GLOO
+
+#endif
@@ -1,111 +1,486 @@
 #include "ObjParser.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <limits>
 #include <sstream>
+#include <thread>
 
+#include "gloo/MappedFile.hpp"
 #include "gloo/utils.hpp"
 
+namespace {
+using namespace GLOO;
+
+// Files are split into about this many bytes per thread, at most one chunk
+// per hardware thread.
+const size_t kMinChunkSize = 1 << 20;
+
+// Commands that affect groups and materials, replayed in file order after
+// the chunks are merged.
+struct ObjEvent {
+  enum class Type { Group, Material, MaterialLib, Skipped, Unknown };
+  Type type;
+  std::string name;
+  // Number of indices in the chunk before the command.
+  size_t index_count;
+};
+
+// One v/vt/vn reference of a face. Indices start at 0; relative indices are
+// chunk-local until the chunks are merged, and missing ones are kNone.
+struct ObjCorner {
+  enum { kPosition, kTexCoord, kNormal };
+  static const long kNone = std::numeric_limits<long>::min();
+
+  long index[3];
+  bool relative[3];
+};
+
+struct ObjChunk {
+  PositionArray positions;
+  NormalArray normals;
+  TexCoordArray tex_coords;
+  // Corners of the triangulated faces, three per triangle.
+  std::vector<ObjCorner> corners;
+  // Scratch space for the corners of the current polygon.
+  std::vector<ObjCorner> face;
+  std::vector<ObjEvent> events;
+};
+
+struct ObjCornerHash {
+  size_t operator()(const ObjCorner& c) const {
+    size_t h = std::hash<long>()(c.index[0]);
+    h ^= std::hash<long>()(c.index[1]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<long>()(c.index[2]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+  }
+};
+
+struct ObjCornerEqual {
+  bool operator()(const ObjCorner& a, const ObjCorner& b) const {
+    return a.index[0] == b.index[0] && a.index[1] == b.index[1] &&
+           a.index[2] == b.index[2];
+  }
+};
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+const char* SkipSpaces(const char* p, const char* end) {
+  while (p < end && IsSpace(*p))
+    p++;
+  return p;
+}
+
+const char* SkipToken(const char* p, const char* end) {
+  while (p < end && !IsSpace(*p))
+    p++;
+  return p;
+}
+
+double Pow10(int exponent) {
+  static const double kTable[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                  1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+                                  1e15, 1e16, 1e17, 1e18, 1e19, 1e20};
+  if (exponent >= 0 && exponent <= 20)
+    return kTable[exponent];
+  if (exponent < 0 && exponent >= -20)
+    return 1.0 / kTable[-exponent];
+  return std::pow(10.0, exponent);
+}
+
+// Parses a decimal number without allocating and without reading past end,
+// unlike strtof which needs a terminated string. Returns the position after
+// the number.
+const char* ParseFloat(const char* p, const char* end, float& value) {
+  p = SkipSpaces(p, end);
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    p++;
+  }
+  double mantissa = 0.0;
+  int exponent = 0;
+  for (; p < end && IsDigit(*p); p++) {
+    mantissa = mantissa * 10.0 + (*p - '0');
+  }
+  if (p < end && *p == '.') {
+    for (p++; p < end && IsDigit(*p); p++) {
+      mantissa = mantissa * 10.0 + (*p - '0');
+      exponent--;
+    }
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    bool negative_exponent = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negative_exponent = *p == '-';
+      p++;
+    }
+    int e = 0;
+    for (; p < end && IsDigit(*p); p++) {
+      e = e * 10 + (*p - '0');
+    }
+    exponent += negative_exponent ? -e : e;
+  }
+  double result = mantissa * Pow10(exponent);
+  value = static_cast<float>(negative ? -result : result);
+  return p;
+}
+
+const char* ParseInt(const char* p, const char* end, long& value) {
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    p++;
+  }
+  long result = 0;
+  for (; p < end && IsDigit(*p); p++) {
+    result = result * 10 + (*p - '0');
+  }
+  value = negative ? -result : result;
+  return p;
+}
+
+std::string ParseName(const char* p, const char* end) {
+  p = SkipSpaces(p, end);
+  return std::string(p, SkipToken(p, end));
+}
+
+bool IsCommand(const char* begin, const char* end, const char* command) {
+  size_t length = std::strlen(command);
+  return static_cast<size_t>(end - begin) == length &&
+         std::memcmp(begin, command, length) == 0;
+}
+
+// Parses one "v", "v/vt", "v//vn" or "v/vt/vn" reference.
+const char* ParseCorner(const char* p,
+                        const char* end,
+                        const ObjChunk& chunk,
+                        ObjCorner& corner) {
+  const size_t counts[3] = {chunk.positions.size(), chunk.tex_coords.size(),
+                            chunk.normals.size()};
+  for (int a = 0; a < 3; a++) {
+    corner.index[a] = ObjCorner::kNone;
+    corner.relative[a] = false;
+    if (a > 0) {
+      if (p == end || *p != '/')
+        continue;
+      p++;
+    }
+    if (p == end || !(IsDigit(*p) || *p == '-' || *p == '+'))
+      continue;
+    long idx;
+    p = ParseInt(p, end, idx);
+    if (idx < 0) {
+      // Relative to the elements defined so far.
+      corner.index[a] = static_cast<long>(counts[a]) + idx;
+      corner.relative[a] = true;
+    } else {
+      // Minus 1 because OBJ indices start with 1.
+      corner.index[a] = idx - 1;
+    }
+  }
+  return SkipToken(p, end);
+}
+
+// Polygons are triangulated as fans, which suits the convex faces
+// exporters write.
+void ParseFace(const char* p, const char* end, ObjChunk& chunk) {
+  chunk.face.clear();
+  while ((p = SkipSpaces(p, end)) < end) {
+    ObjCorner corner;
+    p = ParseCorner(p, end, chunk, corner);
+    chunk.face.push_back(corner);
+  }
+  for (size_t i = 2; i < chunk.face.size(); i++) {
+    chunk.corners.push_back(chunk.face[0]);
+    chunk.corners.push_back(chunk.face[i - 1]);
+    chunk.corners.push_back(chunk.face[i]);
+  }
+}
+
+void ParseChunk(const char* p, const char* end, ObjChunk& chunk) {
+  while (p < end) {
+    const char* line_end =
+        static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (line_end == nullptr)
+      line_end = end;
+
+    const char* command = SkipSpaces(p, line_end);
+    const char* args = SkipToken(command, line_end);
+    if (command == args || *command == '#') {
+      // Empty line or comment.
+    } else if (IsCommand(command, args, "v")) {
+      glm::vec3 v;
+      args = ParseFloat(args, line_end, v.x);
+      args = ParseFloat(args, line_end, v.y);
+      ParseFloat(args, line_end, v.z);
+      chunk.positions.push_back(v);
+    } else if (IsCommand(command, args, "vn")) {
+      glm::vec3 n;
+      args = ParseFloat(args, line_end, n.x);
+      args = ParseFloat(args, line_end, n.y);
+      ParseFloat(args, line_end, n.z);
+      chunk.normals.push_back(n);
+    } else if (IsCommand(command, args, "vt")) {
+      glm::vec2 uv;
+      args = ParseFloat(args, line_end, uv.s);
+      ParseFloat(args, line_end, uv.t);
+      chunk.tex_coords.push_back(uv);
+    } else if (IsCommand(command, args, "f")) {
+      ParseFace(args, line_end, chunk);
+    } else {
+      ObjEvent::Type type;
+      if (IsCommand(command, args, "g"))
+        type = ObjEvent::Type::Group;
+      else if (IsCommand(command, args, "usemtl"))
+        type = ObjEvent::Type::Material;
+      else if (IsCommand(command, args, "mtllib"))
+        type = ObjEvent::Type::MaterialLib;
+      else if (IsCommand(command, args, "o") || IsCommand(command, args, "s"))
+        type = ObjEvent::Type::Skipped;
+      else
+        type = ObjEvent::Type::Unknown;
+      std::string name = type == ObjEvent::Type::Skipped ||
+                                 type == ObjEvent::Type::Unknown
+                             ? std::string(command, args)
+                             : ParseName(args, line_end);
+      chunk.events.push_back({type, std::move(name), chunk.corners.size()});
+    }
+    p = line_end + 1;
+  }
+}
+
+// Splits [data, data + size) into line-aligned ranges and parses them on
+// separate threads.
+std::vector<ObjChunk> ParseChunks(const char* data, size_t size) {
+  size_t num_chunks = std::max<size_t>(
+      1, std::min<size_t>(std::thread::hardware_concurrency(),
+                          size / kMinChunkSize));
+  std::vector<const char*> bounds{data};
+  const char* end = data + size;
+  for (size_t i = 1; i < num_chunks; i++) {
+    const char* p = std::max(bounds.back(), data + size * i / num_chunks);
+    const char* newline =
+        static_cast<const char*>(std::memchr(p, '\n', end - p));
+    bounds.push_back(newline == nullptr ? end : newline + 1);
+  }
+  bounds.push_back(end);
+
+  std::vector<ObjChunk> chunks(num_chunks);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_chunks; i++) {
+    threads.emplace_back(ParseChunk, bounds[i], bounds[i + 1],
+                         std::ref(chunks[i]));
+  }
+  ParseChunk(bounds[0], bounds[1], chunks[0]);
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  return chunks;
+}
+
+template <class T>
+std::unique_ptr<std::vector<T>> Concatenate(
+    std::vector<ObjChunk>& chunks,
+    std::vector<T> ObjChunk::*member) {
+  size_t total = 0;
+  for (ObjChunk& chunk : chunks) {
+    total += (chunk.*member).size();
+  }
+  if (total == 0)
+    return nullptr;
+  auto result = make_unique<std::vector<T>>();
+  result->reserve(total);
+  for (ObjChunk& chunk : chunks) {
+    std::vector<T>& part = chunk.*member;
+    result->insert(result->end(), part.begin(), part.end());
+    std::vector<T>().swap(part);
+  }
+  return result;
+}
+
+template <class T>
+bool InRange(long index, const std::unique_ptr<std::vector<T>>& array) {
+  return index >= 0 && array != nullptr &&
+         static_cast<size_t>(index) < array->size();
+}
+
+// Turns the face corners into an index buffer over deduplicated vertices,
+// one per distinct v/vt/vn combination. Returns false on out-of-range
+// references.
+bool IndexVertices(std::unique_ptr<PositionArray> positions,
+                   std::unique_ptr<NormalArray> normals,
+                   std::unique_ptr<TexCoordArray> tex_coords,
+                   const std::vector<ObjCorner>& corners,
+                   ObjParser::ParsedData& data) {
+  bool uses_normals = false, uses_tex_coords = false;
+  for (const ObjCorner& c : corners) {
+    long n = c.index[ObjCorner::kNormal], uv = c.index[ObjCorner::kTexCoord];
+    if (!InRange(c.index[ObjCorner::kPosition], positions) ||
+        (n != ObjCorner::kNone && !InRange(n, normals)) ||
+        (uv != ObjCorner::kNone && !InRange(uv, tex_coords)))
+      return false;
+    uses_normals |= n != ObjCorner::kNone;
+    uses_tex_coords |= uv != ObjCorner::kNone;
+  }
+
+  if (corners.size() > 0)
+    data.indices = make_unique<IndexArray>();
+  if (!uses_normals && !uses_tex_coords) {
+    // Faces index positions only, so the arrays can be used as they are.
+    for (const ObjCorner& c : corners) {
+      data.indices->push_back(
+          static_cast<unsigned int>(c.index[ObjCorner::kPosition]));
+    }
+    data.positions = std::move(positions);
+    data.normals = std::move(normals);
+    data.tex_coords = std::move(tex_coords);
+    return true;
+  }
+
+  data.positions = make_unique<PositionArray>();
+  if (uses_normals)
+    data.normals = make_unique<NormalArray>();
+  if (uses_tex_coords)
+    data.tex_coords = make_unique<TexCoordArray>();
+  data.indices->reserve(corners.size());
+
+  std::unordered_map<ObjCorner, unsigned int, ObjCornerHash, ObjCornerEqual>
+      vertex_ids;
+  vertex_ids.reserve(positions->size());
+  for (const ObjCorner& c : corners) {
+    auto inserted = vertex_ids.emplace(
+        c, static_cast<unsigned int>(data.positions->size()));
+    if (inserted.second) {
+      data.positions->push_back(positions->at(c.index[ObjCorner::kPosition]));
+      // Corners without an attribute get zeros when other corners have it.
+      if (uses_normals) {
+        long n = c.index[ObjCorner::kNormal];
+        data.normals->push_back(n == ObjCorner::kNone ? glm::vec3(0.0f)
+                                                      : normals->at(n));
+      }
+      if (uses_tex_coords) {
+        long uv = c.index[ObjCorner::kTexCoord];
+        data.tex_coords->push_back(uv == ObjCorner::kNone ? glm::vec2(0.0f)
+                                                          : tex_coords->at(uv));
+      }
+    }
+    data.indices->push_back(inserted.first->second);
+  }
+  return true;
+}
+}  // namespace
+
 namespace GLOO {
 ObjParser::ParsedData ObjParser::Parse(const std::string& file_path,
                                        bool& success) {
   success = false;
-  std::fstream fs(file_path);
-  if (!fs) {
+  MappedFile file(file_path);
+  if (!file.IsOpen()) {
     std::cerr << "ERROR: Unable to open OBJ file " + file_path + "!"
               << std::endl;
     return {};
   }
 
   std::string base_path = GetBasePath(file_path);
+  std::vector<ObjChunk> chunks = ParseChunks(file.GetData(), file.GetSize());
+
+  // Offsets of each chunk in the merged arrays, per corner attribute.
+  std::vector<size_t> index_offsets;
+  size_t num_indices = 0;
+  long attribute_offsets[3] = {0, 0, 0};
+  for (ObjChunk& chunk : chunks) {
+    index_offsets.push_back(num_indices);
+    num_indices += chunk.corners.size();
+    for (ObjCorner& c : chunk.corners) {
+      for (int a = 0; a < 3; a++) {
+        if (c.relative[a]) {
+          c.index[a] += attribute_offsets[a];
+          c.relative[a] = false;
+        }
+      }
+    }
+    attribute_offsets[ObjCorner::kPosition] += chunk.positions.size();
+    attribute_offsets[ObjCorner::kTexCoord] += chunk.tex_coords.size();
+    attribute_offsets[ObjCorner::kNormal] += chunk.normals.size();
+  }
 
   ParsedData data;
-  MaterialDict material_dict;
 
   MeshGroup current_group;
-  std::string line;
-  while (std::getline(fs, line)) {
-    std::stringstream ss(line);
-    std::string command;
-    ss >> command;
-    if (command == "#" || command == "") {
-      continue;
-    } else if (command == "v") {
-      glm::vec3 p;
-      ss >> p.x >> p.y >> p.z;
-      if (data.positions == nullptr)
-        data.positions = make_unique<PositionArray>();
-      data.positions->emplace_back(std::move(p));
-    } else if (command == "vn") {
-      glm::vec3 n;
-      ss >> n.x >> n.y >> n.z;
-      if (data.normals == nullptr)
-        data.normals = make_unique<NormalArray>();
-      data.normals->emplace_back(std::move(n));
-    } else if (command == "vt") {
-      glm::vec2 uv;
-      ss >> uv.s >> uv.t;
-      if (data.tex_coords == nullptr)
-        data.tex_coords = make_unique<TexCoordArray>();
-      data.tex_coords->emplace_back(std::move(uv));
-    } else if (command == "f") {
-      if (data.indices == nullptr)
-        data.indices = make_unique<IndexArray>();
-      for (int t = 0; t < 3; t++) {
-        std::string str;
-        ss >> str;
-        unsigned int idx;
-        if (str.find('/') == std::string::npos) {
-          idx = std::stoul(str);
-        } else {
-          idx = std::stoul(Split(str, '/')[0]);
-        }
-        // Minus 1 because OBJ indices start with 1.
-        data.indices->push_back(idx - 1);
-      }
-    } else if (command == "g") {
-      if (current_group.name != "") {
-        current_group.num_indices =
-            data.indices->size() - current_group.start_face_index;
-        data.groups.push_back(std::move(current_group));
+  for (size_t i = 0; i < chunks.size(); i++) {
+    for (const ObjEvent& event : chunks[i].events) {
+      size_t index_count = index_offsets[i] + event.index_count;
+      switch (event.type) {
+        case ObjEvent::Type::Group:
+          if (current_group.name != "") {
+            current_group.num_indices =
+                index_count - current_group.start_face_index;
+            data.groups.push_back(std::move(current_group));
+          }
+          current_group = MeshGroup();
+          current_group.name = event.name;
+          current_group.start_face_index = index_count;
+          break;
+        case ObjEvent::Type::Material:
+          current_group.material_name = event.name;
+          break;
+        case ObjEvent::Type::MaterialLib:
+          data.material_lib = event.name;
+          break;
+        case ObjEvent::Type::Skipped:
+          std::cout << "Skipped command: " << event.name << std::endl;
+          break;
+        case ObjEvent::Type::Unknown:
+          std::cerr << "Unknown obj command: " << event.name << std::endl;
+          break;
       }
-      ss >> current_group.name;
-      if (data.indices == nullptr)
-        current_group.start_face_index = 0;
-      else
-        current_group.start_face_index = data.indices->size();
-    } else if (command == "usemtl") {
-      ss >> current_group.material_name;
-    } else if (command == "mtllib") {
-      std::string mtl_file;
-      ss >> mtl_file;
-      material_dict = ParseMTL(base_path + mtl_file);
-    } else if (command == "o" || command == "s") {
-      std::cout << "Skipped command: " << command << std::endl;
-    } else {
-      std::cerr << "Unknown obj command: " << command << std::endl;
-      success = false;
-      continue;
     }
   }
 
   if (current_group.name != "") {
-    current_group.num_indices =
-        data.indices->size() - current_group.start_face_index;
+    current_group.num_indices = num_indices - current_group.start_face_index;
     data.groups.push_back(std::move(current_group));
   }
 
-  // Associate materials.
-  for (auto& g : data.groups) {
-    auto itr = material_dict.find(g.material_name);
-    if (itr != material_dict.end())
-      g.material = itr->second;
+  auto corners = Concatenate(chunks, &ObjChunk::corners);
+  if (!IndexVertices(Concatenate(chunks, &ObjChunk::positions),
+                     Concatenate(chunks, &ObjChunk::normals),
+                     Concatenate(chunks, &ObjChunk::tex_coords),
+                     corners ? *corners : std::vector<ObjCorner>(), data)) {
+    std::cerr << "ERROR: Face index out of range in OBJ file " + file_path +
+                     "!"
+              << std::endl;
+    return {};
   }
 
+  if (!data.material_lib.empty())
+    AssociateMaterials(base_path + data.material_lib, data.groups);
+
   success = true;
   return data;
 }
 
+void ObjParser::AssociateMaterials(const std::string& mtl_file_path,
+                                   std::vector<MeshGroup>& groups) {
+  MaterialDict material_dict = ParseMTL(mtl_file_path);
+  for (auto& g : groups) {
+    auto itr = material_dict.find(g.material_name);
+    if (itr != material_dict.end())
+      g.material = itr->second;
+  }
+}
+
 ObjParser::MaterialDict ObjParser::ParseMTL(const std::string& file_path) {
   std::fstream fs(file_path);
   if (!fs) {
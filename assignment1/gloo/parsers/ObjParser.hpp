@@ -18,9 +18,14 @@ class ObjParser {
     std::unique_ptr<TexCoordArray> tex_coords;
 
     std::vector<MeshGroup> groups;
+    // Last mtllib of the file, relative to its directory.
+    std::string material_lib;
   };
 
   static ParsedData Parse(const std::string& file_path, bool& success);
+  // Sets the material of each group from the named MTL file.
+  static void AssociateMaterials(const std::string& mtl_file_path,
+                                 std::vector<MeshGroup>& groups);
 
  private:
   using MaterialDict =
@@ -41,9 +41,11 @@ void PhongShader::AssociateVertexArray(VertexArray& vertex_array) const {
 void PhongShader::SetTargetNode(const SceneNode& node,
                                 const glm::mat4& model_matrix) const {
   // Associate the right VAO before rendering.
-  AssociateVertexArray(node.GetComponentPtr<RenderingComponent>()
-                           ->GetVertexObjectPtr()
-                           ->GetVertexArray());
+  VertexArray& vertex_array = node.GetComponentPtr<RenderingComponent>()
+                                  ->GetVertexObjectPtr()
+                                  ->GetVertexArray();
+  AssociateVertexArray(vertex_array);
+  SetUniform("octahedral_normals", vertex_array.HasOctahedralNormals());
 
   // Set transform.
   glm::mat3 normal_matrix =
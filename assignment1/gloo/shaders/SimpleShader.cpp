@@ -25,6 +25,13 @@ void SimpleShader::AssociateVertexArray(VertexArray& vertex_array) const {
     throw std::runtime_error("Simple shader requires vertex positions!");
   }
   vertex_array.LinkPositionBuffer(GetAttributeLocation("vertex_position"));
+  GLuint offset_location = GetAttributeLocation("instance_offset");
+  if (vertex_array.HasInstanceOffsetBuffer()) {
+    vertex_array.LinkInstanceOffsetBuffer(offset_location);
+  } else {
+    // Disabled attribute arrays read this constant instead.
+    GL_CHECK(glVertexAttrib3f(offset_location, 0.0f, 0.0f, 0.0f));
+  }
 }
 
 void SimpleShader::SetTargetNode(const SceneNode& node,
@@ -4,6 +4,8 @@ uniform mat4 model_matrix;
 uniform mat3 normal_matrix;
 uniform mat4 view_matrix;
 uniform mat4 projection_matrix;
+// Compact vertex format stores normals as two octahedral components.
+uniform bool octahedral_normals;
 
 layout(location = 0) in vec3 vertex_position;
 layout(location = 1) in vec3 vertex_normal;
@@ -13,10 +15,21 @@ out vec3 world_position;
 out vec3 world_normal;
 out vec2 tex_coord;
 
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * s;
+    }
+    return normalize(n);
+}
+
 void main() {
     world_position = vec3(model_matrix * 
         vec4(vertex_position, 1.0));
-    world_normal = normal_matrix * vertex_normal;
+    vec3 normal = octahedral_normals ?
+        DecodeOctahedral(vertex_normal.xy) : vertex_normal;
+    world_normal = normal_matrix * normal;
 
     tex_coord = vertex_tex_coord;
     gl_Position = projection_matrix * view_matrix * vec4(world_position, 1.0);
@@ -5,8 +5,11 @@ uniform mat4 view_matrix;
 uniform mat4 projection_matrix;
 
 layout(location = 0) in vec3 vertex_position;
+// Per instance; zero for vertex arrays that are not instanced.
+layout(location = 1) in vec3 instance_offset;
 
 void main() {
-    vec3 world_position = vec3(model_matrix * vec4(vertex_position, 1.0));
+    vec3 world_position =
+        vec3(model_matrix * vec4(vertex_position + instance_offset, 1.0));
     gl_Position = projection_matrix * view_matrix * vec4(world_position, 1.0);
 }